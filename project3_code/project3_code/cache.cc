@@ -1,409 +1,1529 @@
-#include "cache.h"
-#include <stdlib.h>
-#include <iostream>
-#include <fstream>
-#include <string.h>
-#include <iomanip>
-
-using namespace std;
-
-/* Requirements */
-//	Works with configurable parameters below
-// 	LRU replacement policy
-//	add read/write functions to parser
-//	add print_configuration
-//	add print_statistics (accesses, read/write count, read/write misses, evictions,)
-
-
-cache::cache(unsigned size, 	
-      unsigned associativity,
-      unsigned line_size,
-      write_policy_t wr_hit_policy,
-      write_policy_t wr_miss_policy,
-      unsigned hit_time,
-      unsigned miss_penalty,
-      unsigned address_width
-){
-	/* edit here */
-	cache_size = size;
-    cache_associativity = associativity;
-	cache_line_size = line_size;
-	write_hit_policy = wr_hit_policy;
-	write_miss_policy =wr_miss_policy;
-	cache_hit_time = hit_time;
-	cache_miss_penalty = miss_penalty;
-	cache_address_width = address_width;
-
-	// set count
-	set_count = cache_size / (cache_line_size * cache_associativity);
-
-	idx_bits = 0;
-	offset_bits = 0;
-	
-	// set the index bits
-	unsigned temp = set_count;
-	while (temp >>= 1) ++idx_bits;
-
-	// set the offset bits
-	temp = cache_line_size;
-	while (temp >>= 1) ++offset_bits;
-
-	tag_bits = cache_address_width - idx_bits - offset_bits;
-	//cout << "offset bits: " << offset_bits << endl;
-	//cout << "index bits: " << idx_bits << endl;
-	//cout << "tag bits: " << tag_bits << endl;
-
-	// create masks
-	// offset mask
-	offset_mask =0;
-	for(unsigned i = 0; i < offset_bits; i++){
-		offset_mask |= (1 << i);
-	}
-	//cout << "offset mask: " << std::hex << offset_mask << endl;
-
-	// index mask
-	idx_mask = 0;
-	for(unsigned i = 0; i < idx_bits; i++){
-		idx_mask |= (1 << i);
-	}
-	idx_mask = (idx_mask << offset_bits);
-	//cout << "index mask: " << std::hex << idx_mask << endl;
-
-	// tag mask
-	tag_mask = 0;
-	for(unsigned i = 0; i < tag_bits; i++){
-		tag_mask |= (1 << i);
-	}
-	tag_mask = (tag_mask << (offset_bits + idx_bits));
-	//cout << "tag mask: " << std::hex << tag_mask << endl;
-
-
-	/*
-	tag_mask = (1 << address_width) - 2;
-	cout << "tag mask base: " << std::hex << tag_mask << endl;
-	tag_mask = tag_mask - idx_mask - offset_mask;
-	cout << "tag mask: " << std::hex << tag_mask << endl;*/
-
-
-	// Create a 2d array for the cache of the provided parameters
-	cache_s = new cache_block_t*[cache_associativity];
-	for(unsigned i = 0; i < cache_associativity; i++){
-		cache_s[i] = new cache_block_t[set_count];
-	}
-
-	for( unsigned i = 0; i < cache_associativity; i++){
-		for(unsigned j = 0; j < set_count; j++){
-			cache_s[i][j].tag = UNDEFINED;
-			cache_s[i][j].lru = 0;
-			cache_s[i][j].dirty = 0;
-		}
-	}
-
-
-	// Clear coutners
-	number_memory_accesses = 0;
-	number_reads = 0;
-	number_read_misses = 0;
-	number_writes = 0;
-	number_write_misses = 0;
-	number_evictions = 0;
-	number_mem_writes = 0;
-
-	write_thrus = 0;
-	write_backs = 0;
-	write_allocates = 0;
-	no_write_allocates = 0;
-
-}
-
-void cache::print_configuration(){
-	cout << "CACHE CONFIGURATION" << endl;
-	cout << "size = " << std::dec << (cache_size >> 10 ) << " KB" << endl;
-	cout << "associativity = " << std::dec << cache_associativity << "-way" << endl;
-	cout << "cache line size = " << std::dec << cache_line_size << " B" << endl;
-	cout << "write hit policy = " << get_policy(1) << endl;
-	cout << "write miss policy = " << get_policy(0) << endl;
-	cout << "cache hit time = " << std::dec << cache_hit_time << " CLK" << endl;
-	cout << "cache miss penalty = " << std::dec << cache_miss_penalty << " CLK" << endl;
-	cout << "memory address width = " << std::dec << cache_address_width << " bits" << endl;
-}
-
-cache::~cache(){
-	/* edit here */
-
-	// free the cache array
-	delete(cache_s);
-/*
-	cache_size = UNDEFINED;
-    cache_associativity = UNDEFINED;
-	cache_line_size = UNDEFINED;
-	write_hit_policy = wr_hit_policy;
-	write_miss_policy =wr_miss_policy;
-	cache_hit_time = hit_time;
-	cache_miss_penalty = miss_penalty;
-	cache_address_width = address_width;*/
-
-}
-
-void cache::load_trace(const char *filename){
-   stream.open(filename);
-}
-
-void cache::run(unsigned num_entries){
-
-   unsigned first_access = number_memory_accesses;
-   string line;
-   unsigned line_nr=0;
-
-   while (getline(stream,line)){
-
-	line_nr++;
-    char *str = const_cast<char*>(line.c_str());
-	
-    // tokenize the instruction
-    char *op = strtok (str," ");
-	char *addr = strtok (NULL, " ");
-	address_t address = strtoull(addr, NULL, 16);
-	//cout << "address: " << std::hex << address << endl;
-
-
-	access_type_t access;
-
-	if(op[0] == 'r'){ // read
-		access = read(address);
-		number_reads++;
-
-		if(access == HIT){
-			// do something here?
-
-		} else {
-			number_read_misses++;
-
-
-		}
-	}else{ // write
-		access = write(address);
-		number_writes++;
-
-		if(access == HIT){
-			// do something here?
-
-		} else {
-			number_write_misses++;
-
-
-		}
-
-	}
-
-
-	number_memory_accesses++;
-	if (num_entries!=0 && (number_memory_accesses-first_access)==num_entries)
-		break;
-   }
-}
-
-void cache::print_statistics(){
-	cout << "STATISTICS" << endl;
-	cout << "memory accesses = " << std::dec << number_memory_accesses << endl;
-	cout << "read = " << std::dec  <<  number_reads << endl;
-	cout << "read misses = " << std::dec << number_read_misses << endl;
-	cout << "write = " << std::dec << number_writes << endl;
-	cout << "write misses = " << std::dec << number_write_misses << endl;
-	cout << "evictions = " << std::dec << number_evictions << endl;
-	cout << "memory writes = " << std::dec << num_of_mem_writes() << endl;
-	cout << "average memory access time = " << get_average_access_time() << endl;
-}
-
-access_type_t cache::read(address_t address){
-	/* edit here */
-	unsigned set;
-	unsigned long long tag;
-
-	set = address & idx_mask;
-	set >>= (offset_bits);
-	tag = (unsigned long long) address & tag_mask;
-	tag >>= (idx_bits+offset_bits);
-
-	// check the all cache ways for tag in set
-	for(unsigned i = 0; i < cache_associativity; i++){
-		if(cache_s[i][set].tag == tag){
-			// tag found in cache
-			cache_s[i][set].lru = number_memory_accesses;
-			return HIT;
-		}
-	}
-	// tag not found in cache, bring from memory to cache
-	// first check for free block
-	for(unsigned i = 0; i < cache_associativity; i++){
-		if(cache_s[i][set].tag == UNDEFINED){
-			cache_s[i][set].tag = tag;
-			cache_s[i][set].lru = number_memory_accesses;
-			cache_s[i][set].dirty = 0;
-			return MISS;
-		}
-	}
-	// no free blocks, find way with LRU
-	unsigned way = evict(set);
-
-	// evict way/set in cache
-	cache_s[way][set].tag = tag;
-	cache_s[way][set].dirty = 0;
-	cache_s[way][set].lru = number_memory_accesses;
-
-	return MISS;
-}
-
-access_type_t cache::write(address_t address){
-	unsigned set;
-	unsigned long long tag;
-
-	set = address & idx_mask;
-	set >>= (offset_bits);
-	tag = (unsigned long long) address & tag_mask;
-	tag >>=  (idx_bits+offset_bits);
-
-	// check the all cache ways for tag in set
-	for(unsigned i = 0; i < cache_associativity; i++){
-		if(cache_s[i][set].tag == tag){
-			// tag found in cache
-			if(write_hit_policy == WRITE_THROUGH){
-				// Write-though policy
-				cache_s[i][set].lru = number_memory_accesses; // update LRU
-				//number_mem_writes++; // write to memory
-				write_thrus++;
-			}
-			else{
-				// Write-back policy
-				cache_s[i][set].dirty = 1;
-				cache_s[i][set].lru = number_memory_accesses; // update LRU
-			}
-			return HIT;
-		}
-	}
-
-	// tag not found in cache
-	if(write_miss_policy == NO_WRITE_ALLOCATE){
-		// miss doesn't affect cache; modify memory
-		//number_mem_writes++;
-		no_write_allocates++;
-		return MISS;
-	}
-	// The policy is Write-Allocate
-	// first check for free block
-	for(unsigned i = 0; i < cache_associativity; i++){
-		if(cache_s[i][set].tag == UNDEFINED){
-			cache_s[i][set].tag = tag;
-			cache_s[i][set].lru = number_memory_accesses;
-			cache_s[i][set].dirty = 1;
-			//number_mem_writes++;
-			return MISS;
-		}
-	}
-	// no free blocks, find way with LRU
-	unsigned way = evict(set);
-
-	// evict way/set in cache
-	cache_s[way][set].tag = tag;
-	cache_s[way][set].dirty = 1;
-	cache_s[way][set].lru = number_memory_accesses;
-	//number_mem_writes++;
-
-	write_allocates++;
-
-	return MISS;
-}
-
-void cache::print_tag_array(){
-	cout << "TAG ARRAY" << endl;
-	/* edit here */
-	unsigned i = 0; // block (way)
-	unsigned j = 0;	// index (set)
-
-	for(i = 0; i < cache_associativity; i++){
-		cout << "BLOCKS " << i << endl;
-
-		///// MAKE two sections based on WRITE-HIT policy (dirty bit)
-		if(write_hit_policy == WRITE_BACK){
-			//cout << "  index dirty\t  tag" << endl;
-			cout << setfill(' ') << setw(7) << "index" << setw(6) << "dirty" << setw(4+tag_bits/4) << "tag" << endl; 
-			for(j = 0; j < set_count; j++){
-				if((cache_s[i][j].tag + 1 )!= 0){
-					cout << setfill(' ') << setw(7) << std::dec << j << setw(6) << std::dec << cache_s[i][j].dirty << std::setw(4) << std::hex <<"0x" << cache_s[i][j].tag << endl;
-				}
-			}
-		}
-		else {
-			//cout << "  index \t  tag" << endl;
-			cout << setfill(' ') << setw(7) << "index" << setw(4+tag_bits/4) << "tag" << endl; 
-			for(j = 0; j < set_count; j++){
-				if((cache_s[i][j].tag + 1 )!= 0){
-					cout << setfill(' ') << setw(7) << std::dec << j << std::setw(4) << std::hex <<"0x" << cache_s[i][j].tag << endl;
-				} 
-			}
-		}
-	}
-}
-
-unsigned cache::evict(unsigned set){
-	number_evictions++;
-	//cout << "EVICTION" << endl;
-
-	unsigned lru = cache_s[0][set].lru;
-	unsigned way = 0;
-
-	// find LRU
-	for(unsigned i = 1; i < cache_associativity; i++){
-		// smaller LRU means oldest accessed
-		if(cache_s[i][set].lru < lru){
-			way = i;
-			lru = cache_s[i][set].lru;
-		}
-	}
-
-	// Update memory if block is dirty
-	if(write_hit_policy == WRITE_BACK){	
-		if(cache_s[way][set].dirty == 1) write_backs++;//number_mem_writes++;
-	}
-	
-	return way;
-}
-
-string cache::get_policy(bool type){
-	// get a printable string of the policy type
-	if(type){ // type == 1, then this is for the hit policy
-		if(write_hit_policy == WRITE_THROUGH) return "write-through";
-		else return "write-back";
-	} else { // type == 0, for the miss policy 
-		if(write_miss_policy == WRITE_ALLOCATE) return "write-allocate";
-		else return "no-write-allocate";
-	}
-}
-
-double cache::get_average_access_time(){
-	//int hits = ((number_reads - number_read_misses) + (number_writes - number_write_misses));
-	double miss_rate = double (number_read_misses + number_write_misses) / double (number_memory_accesses);
-
-	double avg = miss_rate*cache_miss_penalty + (double)cache_hit_time;
-	//(hits*cache_hit_time + misses*cache_miss_penalty)/(number_memory_accesses);
-	return avg;
-}
-
-unsigned cache::num_of_mem_writes(){
-	unsigned count = 0;
-
-	if(write_hit_policy == WRITE_BACK){
-		count += write_backs;
-	} else {
-		count += write_thrus;
-	}
-
-	if(write_miss_policy == WRITE_ALLOCATE){
-		count += write_allocates;
-	} else {
-		count += no_write_allocates;
-	}
-
-	return count;
-
+#include "cache.h"
+#include "miss_classifier.h"
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <string.h>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <chrono>
+#include "thread_pool.h"
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+#define SHARD_BATCH 8192		// records handed to a shard thread at once
+#define SHARD_QUEUE_DEPTH 8		// batches queued per shard before the trace reader waits
+
+// batches of records passed from the trace reader to one shard thread
+typedef struct{
+	mutex lock;
+	condition_variable changed;
+	deque< vector<trace_record_t> * > batches;	// NULL marks the end of the trace
+} shard_queue_t;
+
+// statistics of one shard, padded to avoid false sharing between the shard threads
+typedef struct{
+	cache_stats_t st;
+	char pad[64];
+} shard_stats_t;
+
+/* Requirements */
+//	Works with configurable parameters below
+// 	LRU replacement policy
+//	add read/write functions to parser
+//	add print_configuration
+//	add print_statistics (accesses, read/write count, read/write misses, evictions,)
+
+
+cache::cache(unsigned size, 	
+      unsigned associativity,
+      unsigned line_size,
+      write_policy_t wr_hit_policy,
+      write_policy_t wr_miss_policy,
+      unsigned hit_time,
+      unsigned miss_penalty,
+      unsigned address_width,
+      replacement_policy_t policy
+){
+	/* edit here */
+	cache_size = size;
+    cache_associativity = associativity;
+	fully_associative = associativity == 0;
+	if(fully_associative) cache_associativity = size / line_size;
+	cache_line_size = line_size;
+	write_hit_policy = wr_hit_policy;
+	write_miss_policy =wr_miss_policy;
+	cache_hit_time = hit_time;
+	cache_miss_penalty = miss_penalty;
+	cache_address_width = address_width;
+
+	// set count
+	set_count = cache_size / (cache_line_size * cache_associativity);
+
+	idx_bits = 0;
+	offset_bits = 0;
+	
+	// set the index bits
+	unsigned temp = set_count;
+	while (temp >>= 1) ++idx_bits;
+
+	// set the offset bits
+	temp = cache_line_size;
+	while (temp >>= 1) ++offset_bits;
+
+	tag_bits = cache_address_width - idx_bits - offset_bits;
+	//cout << "offset bits: " << offset_bits << endl;
+	//cout << "index bits: " << idx_bits << endl;
+	//cout << "tag bits: " << tag_bits << endl;
+
+	// create masks
+	// offset mask
+	offset_mask =0;
+	for(unsigned i = 0; i < offset_bits; i++){
+		offset_mask |= (1 << i);
+	}
+	//cout << "offset mask: " << std::hex << offset_mask << endl;
+
+	// index mask
+	idx_mask = 0;
+	for(unsigned i = 0; i < idx_bits; i++){
+		idx_mask |= (1 << i);
+	}
+	idx_mask = (idx_mask << offset_bits);
+	//cout << "index mask: " << std::hex << idx_mask << endl;
+
+	// tag mask
+	tag_mask = 0;
+	for(unsigned i = 0; i < tag_bits; i++){
+		tag_mask |= (1 << i);
+	}
+	tag_mask = (tag_mask << (offset_bits + idx_bits));
+	//cout << "tag mask: " << std::hex << tag_mask << endl;
+
+
+	/*
+	tag_mask = (1 << address_width) - 2;
+	cout << "tag mask base: " << std::hex << tag_mask << endl;
+	tag_mask = tag_mask - idx_mask - offset_mask;
+	cout << "tag mask: " << std::hex << tag_mask << endl;*/
+
+
+	// Create the tag store, set-major: the ways of a set are contiguous
+	// (line "way" of set "set" is at index set * cache_associativity + way)
+	size_t lines = (size_t) set_count * cache_associativity;
+	tags = new unsigned long long[lines];
+	dirty = new bool[lines];
+
+	for(size_t i = 0; i < lines; i++){
+		tags[i] = UNDEFINED;
+		dirty[i] = 0;
+	}
+
+	// a fully-associative cache (or any single set with many ways) looks tags up in a hash index,
+	// so that with the LRU list a lookup and an eviction are O(1)
+	tag_index = NULL;
+	index_mask = 0;
+	if(set_count == 1 && cache_associativity >= INDEX_MIN_WAYS){
+		// at most half full
+		unsigned slots = 1;
+		while(slots < 2 * cache_associativity) slots <<= 1;
+		tag_index = new unsigned[slots];
+		for(unsigned i = 0; i < slots; i++) tag_index[i] = 0;
+		index_mask = slots - 1;
+		for(unsigned i = cache_associativity; i-- > 0;) free_ways.push_back(i);
+	}
+
+	replacement_type = policy;
+	replacement = new_replacement_policy(policy, set_count, cache_associativity);
+	future = NULL;
+	future_index = 0;
+	trace_ahead = NULL;
+	trace_records = 0;
+	classifier = NULL;
+	pf = NULL;
+	buffer = NULL;
+	set_counters = NULL;
+	progress_interval = 0;
+	progress_next = 0;
+	progress_count = 0;
+	progress_time = 0;
+	slice_count = 0;
+	slice_warmup = 0;
+	slice_error = 0;
+	sampler = NULL;
+	sample_interval = 0;
+	sample_buffer_hits = 0;
+	sample_index = 0;
+
+
+	// Clear coutners
+	stats.number_memory_accesses = 0;
+	stats.number_reads = 0;
+	stats.number_read_misses = 0;
+	stats.number_writes = 0;
+	stats.number_write_misses = 0;
+	stats.number_evictions = 0;
+	stats.number_mem_writes = 0;
+
+	stats.write_thrus = 0;
+	stats.write_backs = 0;
+	stats.write_allocates = 0;
+	stats.no_write_allocates = 0;
+
+}
+
+void cache::print_configuration(){
+	cout << "CACHE CONFIGURATION" << endl;
+	cout << "size = " << std::dec << (cache_size >> 10 ) << " KB" << endl;
+	cout << "associativity = " << std::dec << cache_associativity << "-way";
+	if(fully_associative) cout << " (fully-associative)";
+	cout << endl;
+	cout << "cache line size = " << std::dec << cache_line_size << " B" << endl;
+	cout << "write hit policy = " << get_policy(1) << endl;
+	cout << "write miss policy = " << get_policy(0) << endl;
+	cout << "cache hit time = " << std::dec << cache_hit_time << " CLK" << endl;
+	cout << "cache miss penalty = " << std::dec << cache_miss_penalty << " CLK" << endl;
+	cout << "memory address width = " << std::dec << cache_address_width << " bits" << endl;
+	if(replacement_type != LRU) cout << "replacement policy = " << replacement->name() << endl;
+}
+
+cache::~cache(){
+	/* edit here */
+	close_interval_stats();
+
+	// free the tag store
+	delete[] tags;
+	delete[] dirty;
+	delete[] tag_index;
+	delete replacement;
+	delete future;
+	delete trace_ahead;
+	delete classifier;
+	delete buffer;
+	delete[] set_counters;
+	if(pf != NULL){
+		delete pf->engine;
+		delete[] pf->prefetched;
+		delete pf;
+	}
+/*
+	cache_size = UNDEFINED;
+    cache_associativity = UNDEFINED;
+	cache_line_size = UNDEFINED;
+	write_hit_policy = wr_hit_policy;
+	write_miss_policy =wr_miss_policy;
+	cache_hit_time = hit_time;
+	cache_miss_penalty = miss_penalty;
+	cache_address_width = address_width;*/
+
+}
+
+void cache::load_trace(const char *filename, bool prefetch){
+   trace_filename = filename;
+   delete trace_ahead;
+   trace_ahead = NULL;
+   trace_records = 0;
+   if(replacement_type == OPT){
+	delete future;
+	future = new trace_buffer;
+	future_index = 0;
+	if(!future->load(filename)) return;
+	future->index_next_use(cache_line_size);
+	return;
+   }
+   if(prefetch){
+	trace_ahead = new trace_prefetcher;
+	trace_ahead->open(filename);
+	return;
+   }
+   trace.open(filename);
+}
+
+unsigned cache::read_trace(trace_record_t *records, unsigned max){
+   unsigned n = trace_ahead != NULL ? trace_ahead->read(records, max) : trace.read(records, max);
+   trace_records += n;
+   return n;
+}
+
+void cache::run(unsigned long long num_entries){
+
+   unsigned long long first_access = stats.number_memory_accesses;
+
+   // OPT: tell the policy the next use of each accessed block
+   if (future != NULL){
+	opt_policy *opt = (opt_policy *) replacement;
+	const trace_record_t *records = future->data();
+	const uint32_t *next_use = future->get_next_use();
+	while (future_index < future->size()){
+		opt->set_next_use(future_index, next_use[future_index]);
+		access(records[future_index].write, records[future_index].address);
+		future_index++;
+		if (progress_interval != 0 && stats.number_memory_accesses >= progress_next) report_progress(stats.number_memory_accesses);
+		if (num_entries!=0 && (stats.number_memory_accesses-first_access)==num_entries)
+			break;
+	}
+	return;
+   }
+
+   // decode the trace in blocks and simulate each block as a batch
+   trace_record_t block[CACHE_BATCH];
+   while (num_entries==0 || (stats.number_memory_accesses-first_access)<num_entries){
+	unsigned max = CACHE_BATCH;
+	if (num_entries!=0 && num_entries-(stats.number_memory_accesses-first_access) < max)
+		max = num_entries-(stats.number_memory_accesses-first_access);
+	unsigned n = read_trace(block, max);
+	access_batch(block, n);
+	if (progress_interval != 0 && stats.number_memory_accesses >= progress_next) report_progress(stats.number_memory_accesses);
+	if (n < max) break; // end of the trace
+   }
+}
+
+// adds to "total" what a shard counted since it started from "base"
+static void merge_stats(cache_stats_t &total, const cache_stats_t &shard, const cache_stats_t &base){
+	total.number_memory_accesses += shard.number_memory_accesses - base.number_memory_accesses;
+	total.number_reads += shard.number_reads - base.number_reads;
+	total.number_read_misses += shard.number_read_misses - base.number_read_misses;
+	total.number_writes += shard.number_writes - base.number_writes;
+	total.number_write_misses += shard.number_write_misses - base.number_write_misses;
+	total.number_evictions += shard.number_evictions - base.number_evictions;
+	total.number_mem_writes += shard.number_mem_writes - base.number_mem_writes;
+	total.write_thrus += shard.write_thrus - base.write_thrus;
+	total.write_backs += shard.write_backs - base.write_backs;
+	total.write_allocates += shard.write_allocates - base.write_allocates;
+	total.no_write_allocates += shard.no_write_allocates - base.no_write_allocates;
+}
+
+static void push_batch(shard_queue_t &q, vector<trace_record_t> *batch){
+	unique_lock<mutex> l(q.lock);
+	while(q.batches.size() >= SHARD_QUEUE_DEPTH) q.changed.wait(l);
+	q.batches.push_back(batch);
+	q.changed.notify_all();
+}
+
+static vector<trace_record_t> *pop_batch(shard_queue_t &q){
+	unique_lock<mutex> l(q.lock);
+	while(q.batches.empty()) q.changed.wait(l);
+	vector<trace_record_t> *batch = q.batches.front();
+	q.batches.pop_front();
+	q.changed.notify_all();
+	return batch;
+}
+
+void cache::run_parallel(unsigned threads, unsigned long long num_entries){
+	if(threads == 0) threads = thread::hardware_concurrency();
+	if(threads > set_count) threads = set_count;
+	if(threads <= 1 || future != NULL || classifier != NULL || pf != NULL || buffer != NULL || sampler != NULL ||
+	   replacement->shared_state()){
+		run(num_entries);
+		return;
+	}
+
+	// the sets touched by a shard are disjoint from the other shards', so each shard can update
+	// the tag array without locking; it counts in private statistics, starting from the current
+	// ones
+	vector<shard_queue_t> queues(threads);
+	vector<shard_stats_t> shards(threads);
+	vector<thread> workers;
+	for(unsigned i = 0; i < threads; i++){
+		shards[i].st = stats;
+		workers.push_back(thread([this, &queues, &shards, i](){
+			while(vector<trace_record_t> *batch = pop_batch(queues[i])){
+				for(size_t j = 0; j < batch->size(); j++) access((*batch)[j].write, (*batch)[j].address, shards[i].st);
+				delete batch;
+			}
+		}));
+	}
+
+	// decode the trace and dispatch each record to the shard owning its set
+	vector< vector<trace_record_t> * > pending(threads);
+	for(unsigned i = 0; i < threads; i++){
+		pending[i] = new vector<trace_record_t>;
+		pending[i]->reserve(SHARD_BATCH);
+	}
+
+	trace_record_t block[CACHE_BATCH];
+	unsigned long long count = 0;
+	while(num_entries == 0 || count < num_entries){
+		unsigned max = CACHE_BATCH;
+		if(num_entries != 0 && num_entries - count < max) max = num_entries - count;
+		unsigned n = read_trace(block, max);
+		for(unsigned i = 0; i < n; i++){
+			unsigned set = (block[i].address & idx_mask) >> offset_bits;
+			unsigned shard = (unsigned long long) set * threads / set_count;
+			pending[shard]->push_back(block[i]);
+			if(pending[shard]->size() == SHARD_BATCH){
+				push_batch(queues[shard], pending[shard]);
+				pending[shard] = new vector<trace_record_t>;
+				pending[shard]->reserve(SHARD_BATCH);
+			}
+		}
+		count += n;
+		// the shards may lag behind: the progress counts the accesses dispatched
+		if(progress_interval != 0 && stats.number_memory_accesses + count >= progress_next)
+			report_progress(stats.number_memory_accesses + count);
+		if(n < max) break; // end of the trace
+	}
+
+	for(unsigned i = 0; i < threads; i++){
+		push_batch(queues[i], pending[i]);
+		push_batch(queues[i], NULL);
+	}
+	for(unsigned i = 0; i < threads; i++) workers[i].join();
+
+	cache_stats_t base = stats;
+	for(unsigned i = 0; i < threads; i++) merge_stats(stats, shards[i].st, base);
+}
+
+// counters of one slice of run_sliced
+typedef struct{
+	cache_stats_t base;					// statistics after the warm-up
+	cache_stats_t end;					// statistics at the end of the slice
+	unsigned long long head;			// misses in the first accesses of the slice (its probe window)
+	unsigned long long overrun;			// misses in the probe window of the next slice, simulated after the end
+} slice_stats_t;
+
+void cache::run_sliced(const trace_record_t *records, size_t count, unsigned slices,
+					   unsigned long long warmup, unsigned threads){
+	if(slices > count) slices = count;
+	if(slices <= 1 || future != NULL || classifier != NULL || pf != NULL || buffer != NULL ||
+	   sampler != NULL || set_counters != NULL){
+		run(records, count);
+		return;
+	}
+
+	// slice k is [first[k], first[k+1]) and its warm-up window the last window[k] accesses before it;
+	// its first probe[k] accesses are also simulated by slice k-1, whose cache is warm, and the
+	// difference between the misses of the two slices there estimates the error of the slice
+	vector<size_t> first(slices + 1), window(slices + 1, 0), probe(slices + 1, 0);
+	for(unsigned k = 0; k <= slices; k++) first[k] = (size_t) k * count / slices;
+	for(unsigned k = 1; k < slices; k++){
+		window[k] = min((size_t) warmup, first[k] - first[k-1]);
+		probe[k] = (first[k+1] - first[k]) / SLICE_PROBE;
+	}
+
+	vector<slice_stats_t> results(slices);
+	thread_pool pool(threads);
+	for(unsigned k = 0; k < slices; k++){
+		pool.submit([this, k, records, &first, &window, &probe, &results](){
+			cache sim(cache_size, fully_associative ? 0 : cache_associativity, cache_line_size,
+					  write_hit_policy, write_miss_policy, cache_hit_time, cache_miss_penalty,
+					  cache_address_width, replacement_type);
+			slice_stats_t &r = results[k];
+
+			// warm-up, not counted
+			sim.access_batch(records + first[k] - window[k], window[k]);
+			r.base = sim.stats;
+
+			// the slice
+			sim.access_batch(records + first[k], probe[k]);
+			r.head = sim.get_misses() - (r.base.number_read_misses + r.base.number_write_misses);
+			sim.access_batch(records + first[k] + probe[k], first[k+1] - first[k] - probe[k]);
+			r.end = sim.stats;
+
+			// probe window of the next slice, not counted
+			sim.access_batch(records + first[k+1], probe[k+1]);
+			r.overrun = sim.get_misses() - (r.end.number_read_misses + r.end.number_write_misses);
+		});
+	}
+	pool.wait();
+
+	slice_count = slices;
+	slice_warmup = warmup;
+	slice_error = 0;
+	for(unsigned k = 0; k < slices; k++){
+		merge_stats(stats, results[k].end, results[k].base);
+		if(k > 0){
+			unsigned long long a = results[k].head, b = results[k-1].overrun;
+			slice_error += a > b ? a - b : b - a;
+		}
+	}
+}
+
+void cache::run_sliced(unsigned slices, unsigned long long warmup, unsigned threads){
+	// OPT: the trace was already decoded with its next uses by load_trace
+	if(future != NULL){
+		run();
+		return;
+	}
+	vector<trace_record_t> records;
+	trace_record_t block[CACHE_BATCH];
+	unsigned n;
+	while((n = read_trace(block, CACHE_BATCH)) != 0) records.insert(records.end(), block, block + n);
+	run_sliced(records.data(), records.size(), slices, warmup, threads);
+}
+
+unsigned long long cache::get_slicing_error(){
+	return slice_error;
+}
+
+bool cache::save_checkpoint(const char *filename){
+	if(classifier != NULL || pf != NULL || buffer != NULL){
+		cerr << "error: checkpoints of caches with a miss classifier, a prefetcher or a victim/miss cache are not supported" << endl;
+		return false;
+	}
+	ofstream out(filename, ios::out | ios::binary | ios::trunc);
+	if(!out.is_open()){
+		cerr << "error: cannot create checkpoint file " << filename << endl;
+		return false;
+	}
+
+	checkpoint_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+	header.version = CHECKPOINT_VERSION;
+	header.size = cache_size;
+	header.associativity = fully_associative ? 0 : cache_associativity;
+	header.line_size = cache_line_size;
+	header.address_width = cache_address_width;
+	header.write_hit_policy = write_hit_policy;
+	header.write_miss_policy = write_miss_policy;
+	header.replacement = replacement_type;
+	header.trace_records = trace_records;
+	header.future_index = future_index;
+	if(set_counters != NULL) header.flags |= CHECKPOINT_SET_STATS;
+	if(trace_ahead == NULL && future == NULL){
+		// the records decoded by the background thread of "trace_ahead" are ahead of the simulation:
+		// its trace is resumed by skipping "trace_records" records instead
+		header.flags |= CHECKPOINT_POSITION;
+		header.position = trace.tell();
+	}
+	out.write((const char *) &header, sizeof(header));
+
+	size_t lines = (size_t) set_count * cache_associativity;
+	out.write((const char *) &stats, sizeof(stats));
+	out.write((const char *) tags, sizeof(unsigned long long) * lines);
+	out.write((const char *) dirty, sizeof(bool) * lines);
+	save_vector(out, free_ways);
+	replacement->save(out);
+	if(set_counters != NULL) out.write((const char *) set_counters, sizeof(set_stats_t) * set_count);
+
+	if(!out.good()){
+		cerr << "error: cannot write checkpoint file " << filename << endl;
+		return false;
+	}
+	return true;
+}
+
+bool cache::load_checkpoint(const char *filename){
+	if(classifier != NULL || pf != NULL || buffer != NULL){
+		cerr << "error: checkpoints of caches with a miss classifier, a prefetcher or a victim/miss cache are not supported" << endl;
+		return false;
+	}
+	ifstream in(filename, ios::in | ios::binary);
+	if(!in.is_open()){
+		cerr << "error: cannot open checkpoint file " << filename << endl;
+		return false;
+	}
+
+	checkpoint_header_t header;
+	in.read((char *) &header, sizeof(header));
+	if(!in || memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 || header.version != CHECKPOINT_VERSION){
+		cerr << "error: malformed checkpoint file " << filename << endl;
+		return false;
+	}
+	if(header.size != cache_size || header.associativity != (fully_associative ? 0 : cache_associativity) ||
+	   header.line_size != cache_line_size || header.address_width != cache_address_width ||
+	   header.write_hit_policy != (uint32_t) write_hit_policy || header.write_miss_policy != (uint32_t) write_miss_policy ||
+	   header.replacement != (uint32_t) replacement_type){
+		cerr << "error: checkpoint " << filename << " was saved by a cache with another configuration" << endl;
+		return false;
+	}
+
+	// the whole state is read into temporaries, and the cache is only updated once all of it was read
+	// (a truncated or malformed file leaves the cache unchanged)
+	size_t lines = (size_t) set_count * cache_associativity;
+	cache_stats_t new_stats;
+	vector<unsigned long long> new_tags(lines);
+	vector<char> new_dirty(lines * sizeof(bool));
+	in.read((char *) &new_stats, sizeof(new_stats));
+	in.read((char *) new_tags.data(), sizeof(unsigned long long) * lines);
+	in.read(new_dirty.data(), sizeof(bool) * lines);
+	bool valid = (bool) in;
+	for(size_t line = 0; valid && line < new_dirty.size(); line++) valid = new_dirty[line] == 0 || new_dirty[line] == 1;
+
+	// free ways (indexed single set)
+	uint64_t free_count = 0;
+	in.read((char *) &free_count, sizeof(free_count));
+	valid = valid && (bool) in && free_count <= cache_associativity;
+	vector<unsigned> new_free_ways(valid ? free_count : 0);
+	if(valid){
+		in.read((char *) new_free_ways.data(), sizeof(unsigned) * free_count);
+		valid = (bool) in;
+		for(size_t i = 0; valid && i < new_free_ways.size(); i++) valid = new_free_ways[i] < cache_associativity;
+	}
+
+	// the replacement state is loaded into a new policy, which replaces the current one on success
+	replacement_policy *new_replacement = new_replacement_policy(replacement_type, set_count, cache_associativity);
+	valid = valid && new_replacement->load(in);
+	vector<set_stats_t> new_set_counters;
+	if(valid && (header.flags & CHECKPOINT_SET_STATS)){
+		new_set_counters.resize(set_count);
+		in.read((char *) new_set_counters.data(), sizeof(set_stats_t) * set_count);
+		valid = (bool) in;
+	}
+	if(!valid){
+		delete new_replacement;
+		cerr << "error: malformed checkpoint file " << filename << endl;
+		return false;
+	}
+
+	stats = new_stats;
+	memcpy(tags, new_tags.data(), sizeof(unsigned long long) * lines);
+	memcpy(dirty, new_dirty.data(), sizeof(bool) * lines);
+	free_ways.swap(new_free_ways);
+	delete replacement;
+	replacement = new_replacement;
+	if(!new_set_counters.empty()){
+		enable_set_statistics();
+		memcpy(set_counters, new_set_counters.data(), sizeof(set_stats_t) * set_count);
+	}
+
+	// rebuild the tag index from the tags
+	if(tag_index != NULL){
+		memset(tag_index, 0, sizeof(unsigned) * (index_mask + 1));
+		for(size_t line = 0; line < lines; line++){
+			if(tags[line] == UNDEFINED) continue;
+			unsigned s = index_slot(tags[line]);
+			while(tag_index[s] != 0) s = (s + 1) & index_mask;
+			tag_index[s] = line + 1;
+		}
+	}
+
+	// the interval statistics restart from the restored counters
+	if(sampler != NULL){
+		sample_base = stats;
+		sample_buffer_hits = 0;
+	}
+
+	// resume the loaded trace after the last record simulated
+	if(future != NULL){
+		future_index = header.future_index <= future->size() ? header.future_index : future->size();
+	}else if(trace_ahead == NULL && (header.flags & CHECKPOINT_POSITION)){
+		if(trace.seek(header.position)) trace_records = header.trace_records;
+		else cerr << "warning: the trace loaded does not match checkpoint " << filename << endl;
+	}else if(!trace_filename.empty()){
+		// skip the records simulated before the checkpoint, from the start of the trace
+		string filename = trace_filename;
+		load_trace(filename.c_str(), trace_ahead != NULL);
+		trace_record_t block[CACHE_BATCH];
+		while(trace_records < header.trace_records){
+			unsigned max = CACHE_BATCH;
+			if(header.trace_records - trace_records < max) max = header.trace_records - trace_records;
+			if(read_trace(block, max) < max) break; // end of the trace
+		}
+	}
+	return true;
+}
+
+void cache::run(const trace_record_t *records, size_t count){
+	if(replacement_type == OPT){
+		cerr << "error: OPT replacement needs a trace loaded with load_trace" << endl;
+		return;
+	}
+	access_batch(records, count);
+}
+
+access_type_t cache::access(bool is_write, address_t address){
+	return access(is_write, address, stats);
+}
+
+access_type_t cache::access(bool is_write, address_t address, cache_victim_t &victim){
+	return access(is_write, address, stats, &victim);
+}
+
+access_type_t cache::access(bool is_write, address_t address, cache_stats_t &st, cache_victim_t *victim){
+	access_type_t result;
+
+	if(victim != NULL) victim->valid = false;
+	if(!is_write){ // read
+		result = read(address, st, victim);
+		st.number_reads++;
+		if(result == MISS) st.number_read_misses++;
+	}else{ // write
+		result = write(address, st, victim);
+		st.number_writes++;
+		if(result == MISS) st.number_write_misses++;
+	}
+
+	st.number_memory_accesses++;
+	if(classifier != NULL) classifier->classify(is_write, address, result);
+	if(pf != NULL) prefetch_access(address, result);
+	if(sampler != NULL) interval_check();
+	return result;
+}
+
+void cache::print_statistics(){
+	cout << "STATISTICS" << endl;
+	cout << "memory accesses = " << std::dec << stats.number_memory_accesses << endl;
+	cout << "read = " << std::dec  <<  stats.number_reads << endl;
+	cout << "read misses = " << std::dec << stats.number_read_misses << endl;
+	cout << "write = " << std::dec << stats.number_writes << endl;
+	cout << "write misses = " << std::dec << stats.number_write_misses << endl;
+	cout << "evictions = " << std::dec << stats.number_evictions << endl;
+	cout << "memory writes = " << std::dec << num_of_mem_writes() << endl;
+	cout << "average memory access time = " << get_average_access_time() << endl;
+	if(classifier != NULL) classifier->print_statistics();
+	if(pf != NULL) print_prefetch_statistics();
+	if(buffer != NULL){
+		buffer->print_statistics();
+		double miss_rate = double (stats.number_read_misses + stats.number_write_misses) / double (stats.number_memory_accesses);
+		cout << "average memory access time without " << (buffer->is_miss_cache() ? "miss" : "victim")
+			 << " cache = " << miss_rate*cache_miss_penalty + (double)cache_hit_time << endl;
+	}
+	replacement->print_statistics();
+	print_set_statistics();
+	if(slice_count != 0){
+		unsigned long long misses = stats.number_read_misses + stats.number_write_misses;
+		cout << "time slices = " << std::dec << slice_count << " (warm-up = " << slice_warmup << " accesses)" << endl;
+		cout << "estimated slicing error = " << std::dec << slice_error << " misses";
+		if(misses != 0) cout << " (" << 100.0 * slice_error / misses << " %)";
+		cout << endl;
+	}
+}
+
+void cache::attach_victim_cache(unsigned entries, bool miss_cache, unsigned hit_time){
+	delete buffer;
+	buffer = new victim_cache(entries, miss_cache, hit_time);
+}
+
+victim_cache *cache::get_victim_cache(){
+	return buffer;
+}
+
+inline bool cache::buffer_lookup(unsigned set, unsigned long long tag, bool &was_dirty){
+	return buffer->lookup((tag << idx_bits) | set, was_dirty);
+}
+
+void cache::enable_miss_classification(){
+	if(classifier == NULL) classifier = new miss_classifier(cache_size, cache_line_size, write_miss_policy, cache_address_width);
+}
+
+miss_classifier *cache::get_miss_classifier(){
+	return classifier;
+}
+
+// returns the first way of "set" holding "tag" (UNDEFINED finds a free way), or cache_associativity
+inline unsigned cache::find_way(unsigned set, unsigned long long tag){
+	if(tag_index != NULL){
+		if(tag == UNDEFINED) return free_ways.empty() ? cache_associativity : free_ways.back();
+		for(unsigned s = index_slot(tag); tag_index[s] != 0; s = (s + 1) & index_mask){
+			if(tags[tag_index[s] - 1] == tag) return tag_index[s] - 1;
+		}
+		return cache_associativity;
+	}
+
+	const unsigned long long *set_tags = tags + (size_t) set * cache_associativity;
+	unsigned i = 0;
+
+#ifdef __AVX2__
+	// 4 tags per comparison
+	__m256i key4 = _mm256_set1_epi64x(tag);
+	for(; i + 4 <= cache_associativity; i += 4){
+		__m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(set_tags + i)), key4);
+		int match = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+		if(match) return i + __builtin_ctz(match);
+	}
+#endif
+#ifdef __SSE2__
+	// 2 tags per comparison: a 64-bit lane matches if both of its 32-bit halves match
+	__m128i key2 = _mm_set1_epi64x(tag);
+	for(; i + 2 <= cache_associativity; i += 2){
+		__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(set_tags + i)), key2);
+		eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2,3,0,1)));
+		int match = _mm_movemask_pd(_mm_castsi128_pd(eq));
+		if(match) return i + __builtin_ctz(match);
+	}
+#endif
+	for(; i < cache_associativity; i++){
+		if(set_tags[i] == tag) return i;
+	}
+	return cache_associativity;
+}
+
+inline unsigned cache::index_slot(unsigned long long tag){
+	tag ^= tag >> 33;
+	tag *= 0xff51afd7ed558ccdULL;
+	tag ^= tag >> 33;
+	return tag & index_mask;
+}
+
+inline void cache::set_line(size_t line, unsigned long long tag){
+	if(pf != NULL) pf->prefetched[line] = 0;
+	if(tag_index == NULL){
+		tags[line] = tag;
+		return;
+	}
+
+	// single set: the line index is the way
+	if(tags[line] != UNDEFINED){
+		// remove the old tag, shifting back the lines probed after it (linear probing deletion)
+		unsigned hole = index_slot(tags[line]);
+		while(tag_index[hole] != line + 1) hole = (hole + 1) & index_mask;
+		tag_index[hole] = 0;
+		for(unsigned s = (hole + 1) & index_mask; tag_index[s] != 0; s = (s + 1) & index_mask){
+			unsigned home = index_slot(tags[tag_index[s] - 1]);
+			// the entry can move to the hole if its home slot is not in (hole, s]
+			if(((s - home) & index_mask) >= ((s - hole) & index_mask)){
+				tag_index[hole] = tag_index[s];
+				tag_index[s] = 0;
+				hole = s;
+			}
+		}
+	}else if(!free_ways.empty() && free_ways.back() == line){
+		free_ways.pop_back();
+	}
+
+	tags[line] = tag;
+	if(tag != UNDEFINED){
+		unsigned s = index_slot(tag);
+		while(tag_index[s] != 0) s = (s + 1) & index_mask;
+		tag_index[s] = line + 1;
+	}else{
+		free_ways.push_back(line);
+	}
+}
+
+access_type_t cache::read(address_t address){
+	return read(address, stats);
+}
+
+access_type_t cache::read(address_t address, cache_stats_t &st, cache_victim_t *victim){
+	/* edit here */
+	unsigned set;
+	unsigned long long tag;
+
+	set = address & idx_mask;
+	set >>= (offset_bits);
+	tag = (unsigned long long) address & tag_mask;
+	tag >>= (idx_bits+offset_bits);
+
+	return read_line(set, tag, st, victim);
+}
+
+inline access_type_t cache::read_line(unsigned set, unsigned long long tag, cache_stats_t &st, cache_victim_t *victim){
+	size_t base = (size_t) set * cache_associativity;
+
+	// check the all cache ways for tag in set
+	unsigned way = find_way(set, tag);
+	if(set_counters != NULL) set_counters[set].accesses++;
+	if(way < cache_associativity){
+		// tag found in cache
+		if(pf != NULL && pf->prefetched[base + way]) prefetch_hit(base + way);
+		replacement->touch(set, way);
+		return HIT;
+	}
+	// tag not found in cache, bring from memory (or the victim cache) to cache
+	if(set_counters != NULL) set_counters[set].misses++;
+	bool was_dirty = false;
+	if(buffer != NULL) buffer_lookup(set, tag, was_dirty);
+
+	// first check for free block, otherwise find way with LRU
+	way = find_way(set, UNDEFINED);
+	if(way == cache_associativity) way = evict(set, st, victim);
+
+	// fill way/set in cache
+	set_line(base + way, tag);
+	dirty[base + way] = was_dirty;
+	replacement->insert(set, way);
+
+	return MISS;
+}
+
+access_type_t cache::write(address_t address){
+	return write(address, stats);
+}
+
+access_type_t cache::write(address_t address, cache_stats_t &st, cache_victim_t *victim){
+	unsigned set;
+	unsigned long long tag;
+
+	set = address & idx_mask;
+	set >>= (offset_bits);
+	tag = (unsigned long long) address & tag_mask;
+	tag >>=  (idx_bits+offset_bits);
+
+	return write_line(set, tag, st, victim);
+}
+
+inline access_type_t cache::write_line(unsigned set, unsigned long long tag, cache_stats_t &st, cache_victim_t *victim){
+	size_t base = (size_t) set * cache_associativity;
+
+	// check the all cache ways for tag in set
+	unsigned way = find_way(set, tag);
+	if(set_counters != NULL) set_counters[set].accesses++;
+	if(way < cache_associativity){
+		// tag found in cache
+		if(pf != NULL && pf->prefetched[base + way]) prefetch_hit(base + way);
+		if(write_hit_policy == WRITE_THROUGH){
+			// Write-though policy
+			replacement->touch(set, way); // update LRU
+			//number_mem_writes++; // write to memory
+			st.write_thrus++;
+		}
+		else{
+			// Write-back policy
+			dirty[base + way] = 1;
+			replacement->touch(set, way); // update LRU
+		}
+		return HIT;
+	}
+
+	// tag not found in cache
+	if(set_counters != NULL) set_counters[set].misses++;
+	if(write_miss_policy == NO_WRITE_ALLOCATE){
+		// miss doesn't affect cache; modify memory (and the copy in the victim/miss cache, if any)
+		//number_mem_writes++;
+		st.no_write_allocates++;
+		if(buffer != NULL) buffer->write((tag << idx_bits) | set);
+		return MISS;
+	}
+	// The policy is Write-Allocate
+	bool was_dirty = false;
+	if(buffer != NULL) buffer_lookup(set, tag, was_dirty);
+
+	// first check for free block
+	way = find_way(set, UNDEFINED);
+	if(way < cache_associativity){
+		set_line(base + way, tag);
+		replacement->insert(set, way);
+		dirty[base + way] = 1;
+		//number_mem_writes++;
+		return MISS;
+	}
+	// no free blocks, find way with LRU
+	way = evict(set, st, victim);
+
+	// evict way/set in cache
+	set_line(base + way, tag);
+	dirty[base + way] = 1;
+	replacement->insert(set, way);
+	//number_mem_writes++;
+
+	st.write_allocates++;
+
+	return MISS;
+}
+
+void cache::decode_batch(const address_t *addresses, unsigned count, unsigned long long *sets, unsigned long long *keys){
+	unsigned shift = idx_bits + offset_bits;
+	unsigned i = 0;
+
+#ifdef __AVX2__
+	// 4 addresses per iteration
+	__m256i set_mask = _mm256_set1_epi64x(idx_mask);
+	__m256i key_mask = _mm256_set1_epi64x(tag_mask);
+	__m128i set_shift = _mm_cvtsi32_si128(offset_bits);
+	__m128i key_shift = _mm_cvtsi32_si128(shift);
+	for(; i + 4 <= count; i += 4){
+		__m256i a = _mm256_loadu_si256((const __m256i *)(addresses + i));
+		_mm256_storeu_si256((__m256i *)(sets + i), _mm256_srl_epi64(_mm256_and_si256(a, set_mask), set_shift));
+		_mm256_storeu_si256((__m256i *)(keys + i), _mm256_srl_epi64(_mm256_and_si256(a, key_mask), key_shift));
+	}
+#endif
+	for(; i < count; i++){
+		sets[i] = (addresses[i] & idx_mask) >> offset_bits;
+		keys[i] = (addresses[i] & tag_mask) >> shift;
+	}
+}
+
+void cache::access_batch(const trace_record_t *records, size_t count, access_type_t *results){
+	address_t addresses[CACHE_BATCH];
+	unsigned long long sets[CACHE_BATCH];
+	unsigned long long keys[CACHE_BATCH];
+
+	unsigned n;
+	for(size_t first = 0; first < count; first += n){
+		n = count - first < CACHE_BATCH ? count - first : CACHE_BATCH;
+		if(sampler != NULL){ // do not cross the end of the interval
+			unsigned long long left = sample_interval - (stats.number_memory_accesses - sample_base.number_memory_accesses);
+			if(n > left) n = left;
+		}
+		const trace_record_t *block = records + first;
+
+		for(unsigned i = 0; i < n; i++) addresses[i] = block[i].address;
+		decode_batch(addresses, n, sets, keys);
+
+		unsigned writes = 0, read_misses = 0, write_misses = 0;
+		for(unsigned i = 0; i < n; i++){
+			access_type_t result;
+			if(!block[i].write){
+				result = read_line(sets[i], keys[i], stats, NULL);
+				read_misses += result == MISS;
+			}else{
+				result = write_line(sets[i], keys[i], stats, NULL);
+				writes++;
+				write_misses += result == MISS;
+			}
+			if(results != NULL) results[first + i] = result;
+			if(classifier != NULL) classifier->classify(block[i].write, block[i].address, result);
+			if(pf != NULL) prefetch_access(block[i].address, result);
+		}
+
+		stats.number_memory_accesses += n;
+		stats.number_reads += n - writes;
+		stats.number_read_misses += read_misses;
+		stats.number_writes += writes;
+		stats.number_write_misses += write_misses;
+		if(sampler != NULL) interval_check();
+	}
+}
+
+void cache::access_batch(bool is_write, const address_t *addresses, size_t count, access_type_t *results){
+	unsigned long long sets[CACHE_BATCH];
+	unsigned long long keys[CACHE_BATCH];
+
+	unsigned n;
+	for(size_t first = 0; first < count; first += n){
+		n = count - first < CACHE_BATCH ? count - first : CACHE_BATCH;
+		if(sampler != NULL){ // do not cross the end of the interval
+			unsigned long long left = sample_interval - (stats.number_memory_accesses - sample_base.number_memory_accesses);
+			if(n > left) n = left;
+		}
+		decode_batch(addresses + first, n, sets, keys);
+
+		unsigned misses = 0;
+		for(unsigned i = 0; i < n; i++){
+			access_type_t result = is_write ? write_line(sets[i], keys[i], stats, NULL)
+											: read_line(sets[i], keys[i], stats, NULL);
+			misses += result == MISS;
+			if(results != NULL) results[first + i] = result;
+			if(classifier != NULL) classifier->classify(is_write, addresses[first + i], result);
+			if(pf != NULL) prefetch_access(addresses[first + i], result);
+		}
+
+		stats.number_memory_accesses += n;
+		if(is_write){
+			stats.number_writes += n;
+			stats.number_write_misses += misses;
+		}else{
+			stats.number_reads += n;
+			stats.number_read_misses += misses;
+		}
+		if(sampler != NULL) interval_check();
+	}
+}
+
+void cache::read_batch(const address_t *addresses, size_t count, access_type_t *results){
+	access_batch(false, addresses, count, results);
+}
+
+void cache::write_batch(const address_t *addresses, size_t count, access_type_t *results){
+	access_batch(true, addresses, count, results);
+}
+
+void cache::print_tag_array(){
+	cout << "TAG ARRAY" << endl;
+	/* edit here */
+	unsigned i = 0; // block (way)
+	unsigned j = 0;	// index (set)
+
+	for(i = 0; i < cache_associativity; i++){
+		cout << "BLOCKS " << i << endl;
+
+		///// MAKE two sections based on WRITE-HIT policy (dirty bit)
+		if(write_hit_policy == WRITE_BACK){
+			//cout << "  index dirty\t  tag" << endl;
+			cout << setfill(' ') << setw(7) << "index" << setw(6) << "dirty" << setw(4+tag_bits/4) << "tag" << endl; 
+			for(j = 0; j < set_count; j++){
+				if((tags[(size_t) j * cache_associativity + i] + 1 )!= 0){
+					cout << setfill(' ') << setw(7) << std::dec << j << setw(6) << std::dec << dirty[(size_t) j * cache_associativity + i] << std::setw(4) << std::hex <<"0x" << tags[(size_t) j * cache_associativity + i] << endl;
+				}
+			}
+		}
+		else {
+			//cout << "  index \t  tag" << endl;
+			cout << setfill(' ') << setw(7) << "index" << setw(4+tag_bits/4) << "tag" << endl; 
+			for(j = 0; j < set_count; j++){
+				if((tags[(size_t) j * cache_associativity + i] + 1 )!= 0){
+					cout << setfill(' ') << setw(7) << std::dec << j << std::setw(4) << std::hex <<"0x" << tags[(size_t) j * cache_associativity + i] << endl;
+				} 
+			}
+		}
+	}
+}
+
+unsigned cache::evict(unsigned set){
+	return evict(set, stats);
+}
+
+unsigned cache::evict(unsigned set, cache_stats_t &st, cache_victim_t *victim){
+	st.number_evictions++;
+	//cout << "EVICTION" << endl;
+
+	// find the victim (LRU by default)
+	unsigned way = replacement->victim(set);
+	size_t line = (size_t) set * cache_associativity + way;
+
+	// Update memory if block is dirty
+	bool written_back = false;
+	if(buffer != NULL && !buffer->is_miss_cache()){
+		// the victim cache keeps the line, and writes back the dirty line it evicts
+		address_t block = (tags[line] << idx_bits) | set;
+		written_back = buffer->insert(block, write_hit_policy == WRITE_BACK && dirty[line]);
+	}
+	else if(write_hit_policy == WRITE_BACK){	
+		written_back = dirty[line] == 1;//number_mem_writes++;
+	}
+	if(written_back) st.write_backs++;
+	if(set_counters != NULL){
+		set_counters[set].evictions++;
+		set_counters[set].write_backs += written_back;
+	}
+	if(pf != NULL && pf->prefetched[line]) pf->stats.useless++;
+
+	if(victim != NULL){
+		victim->valid = true;
+		victim->address = (tags[line] << (idx_bits + offset_bits)) | ((address_t) set << offset_bits);
+		victim->dirty = write_hit_policy == WRITE_BACK && dirty[line];
+	}
+	
+	return way;
+}
+
+inline unsigned cache::locate(address_t address, unsigned &set, unsigned long long &tag){
+	set = (address & idx_mask) >> offset_bits;
+	tag = (address & tag_mask) >> (idx_bits + offset_bits);
+	return find_way(set, tag);
+}
+
+bool cache::probe(address_t address){
+	unsigned set;
+	unsigned long long tag;
+	return locate(address, set, tag) < cache_associativity;
+}
+
+void cache::get_lines(vector<address_t> &addresses){
+	for(unsigned set = 0; set < set_count; set++){
+		for(unsigned way = 0; way < cache_associativity; way++){
+			unsigned long long tag = tags[(size_t) set * cache_associativity + way];
+			if(tag != UNDEFINED) addresses.push_back((tag << (idx_bits + offset_bits)) | ((address_t) set << offset_bits));
+		}
+	}
+}
+
+void cache::fill(address_t address, bool is_dirty, cache_victim_t &victim){
+	unsigned set;
+	unsigned long long tag;
+	unsigned way = locate(address, set, tag);
+	size_t base = (size_t) set * cache_associativity;
+	bool mark = is_dirty && write_hit_policy == WRITE_BACK;
+
+	victim.valid = false;
+	if(way < cache_associativity){
+		// already cached: merge the dirty data
+		if(mark) dirty[base + way] = 1;
+		replacement->touch(set, way);
+		return;
+	}
+	way = find_way(set, UNDEFINED);
+	if(way == cache_associativity) way = evict(set, stats, &victim);
+	set_line(base + way, tag);
+	dirty[base + way] = mark;
+	replacement->insert(set, way);
+}
+
+bool cache::invalidate(address_t address, bool &was_dirty){
+	unsigned set;
+	unsigned long long tag;
+	unsigned way = locate(address, set, tag);
+	if(way == cache_associativity){
+		was_dirty = false;
+		return false;
+	}
+	size_t line = (size_t) set * cache_associativity + way;
+	was_dirty = write_hit_policy == WRITE_BACK && dirty[line];
+	set_line(line, UNDEFINED);
+	dirty[line] = 0;
+	return true;
+}
+
+access_type_t cache::extract(address_t address, bool &was_dirty){
+	stats.number_memory_accesses++;
+	stats.number_reads++;
+	access_type_t result = HIT;
+	if(!invalidate(address, was_dirty)){
+		stats.number_read_misses++;
+		result = MISS;
+	}
+	if(sampler != NULL) interval_check();
+	return result;
+}
+
+void cache::enable_prefetcher(prefetcher_t type, unsigned degree, bool throttle, unsigned latency){
+	if(pf != NULL || type == NO_PREFETCH) return;
+
+	size_t lines = (size_t) set_count * cache_associativity;
+	pf = new prefetch_state_t;
+	pf->engine = new_prefetcher(type, cache_line_size);
+	pf->degree = degree ? degree : 1;
+	pf->throttle = throttle;
+	pf->latency = latency;
+	pf->prefetched = new bool[lines];
+	for(size_t i = 0; i < lines; i++) pf->prefetched[i] = 0;
+	pf->filter.assign(POLLUTION_FILTER, 0);
+	memset(&pf->stats, 0, sizeof(pf->stats));
+	pf->interval_issued = 0;
+	pf->interval_useful = 0;
+	pf->clock = 0;
+	pf->trained = false;
+}
+
+prefetch_stats_t cache::get_prefetch_stats(){
+	prefetch_stats_t none;
+	memset(&none, 0, sizeof(none));
+	return pf != NULL ? pf->stats : none;
+}
+
+inline void cache::prefetch_hit(size_t line){
+	pf->prefetched[line] = 0;
+	pf->stats.useful++;
+	pf->trained = true;
+}
+
+// slot of the pollution filter remembering "block"
+static inline unsigned filter_slot(address_t block){
+	return (block * 0x9e3779b97f4a7c15ULL) >> 52 & (POLLUTION_FILTER - 1);
+}
+
+void cache::prefetch_fill(address_t block){
+	unsigned set;
+	unsigned long long tag;
+	unsigned way = locate(block << offset_bits, set, tag);
+	size_t base = (size_t) set * cache_associativity;
+
+	if(way < cache_associativity){
+		// cached by a demand access while in flight
+		pf->stats.redundant++;
+		return;
+	}
+	way = find_way(set, UNDEFINED);
+	if(way == cache_associativity){
+		way = evict(set, stats, NULL);
+		// remember the demand lines displaced by prefetches
+		if(!pf->prefetched[base + way]){
+			address_t victim = (tags[base + way] << idx_bits) | set;
+			pf->filter[filter_slot(victim)] = victim + 1;
+		}
+	}
+	set_line(base + way, tag);
+	dirty[base + way] = 0;
+	replacement->insert(set, way);
+	pf->prefetched[base + way] = 1;
+	pf->stats.issued++;
+}
+
+void cache::prefetch_access(address_t address, access_type_t result){
+	address_t block = address >> offset_bits;
+
+	// train on demand misses and on the first hit to each prefetched line
+	bool train = pf->trained;
+	pf->trained = false;
+	if(result == MISS){
+		train = true;
+		for(deque<prefetch_request_t>::iterator it = pf->queue.begin(); it != pf->queue.end(); ++it){
+			if(it->block == block){
+				pf->stats.late++;
+				pf->queue.erase(it);
+				break;
+			}
+		}
+		unsigned slot = filter_slot(block);
+		if(pf->filter[slot] == block + 1){
+			pf->stats.pollution++;
+			pf->filter[slot] = 0;
+		}
+	}
+	if(train) prefetch_issue(block, result);
+
+	// fill the prefetched lines arriving before the next access
+	pf->clock++;
+	while(!pf->queue.empty() && pf->queue.front().ready <= pf->clock){
+		prefetch_fill(pf->queue.front().block);
+		pf->queue.pop_front();
+	}
+}
+
+void cache::prefetch_issue(address_t block, access_type_t result){
+	pf->candidates.clear();
+	pf->engine->train(block, result == MISS, pf->degree, pf->candidates);
+	for(size_t i = 0; i < pf->candidates.size(); i++){
+		address_t candidate = pf->candidates[i];
+		bool pending = probe(candidate << offset_bits);
+		for(size_t q = 0; !pending && q < pf->queue.size(); q++) pending = pf->queue[q].block == candidate;
+		if(pending){
+			pf->stats.redundant++;
+		}else if(pf->latency == 0){
+			prefetch_fill(candidate);
+		}else if(pf->queue.size() == PREFETCH_QUEUE){
+			pf->stats.dropped++;
+		}else{
+			prefetch_request_t request = {candidate, pf->clock + pf->latency};
+			pf->queue.push_back(request);
+		}
+	}
+
+	// throttling: adjust the degree to the accuracy of the last interval
+	unsigned long long issued = pf->stats.issued - pf->interval_issued;
+	if(pf->throttle && issued >= PREFETCH_INTERVAL){
+		double accuracy = (double)(pf->stats.useful - pf->interval_useful) / (double) issued;
+		if(accuracy > PREFETCH_HIGH_ACCURACY && pf->degree < PREFETCH_MAX_DEGREE) pf->degree++;
+		else if(accuracy < PREFETCH_LOW_ACCURACY && pf->degree > 1) pf->degree--;
+		pf->interval_issued = pf->stats.issued;
+		pf->interval_useful = pf->stats.useful;
+	}
+}
+
+void cache::print_prefetch_statistics(){
+	const prefetch_stats_t &p = pf->stats;
+	unsigned long long misses = stats.number_read_misses + stats.number_write_misses;
+	cout << "prefetcher = " << pf->engine->name() << endl;
+	cout << "prefetch degree = " << std::dec << pf->degree << endl;
+	cout << "prefetches issued = " << std::dec << p.issued << endl;
+	cout << "useful prefetches = " << std::dec << p.useful << endl;
+	cout << "useless prefetches = " << std::dec << p.useless << endl;
+	cout << "late prefetches = " << std::dec << p.late << endl;
+	cout << "redundant prefetches = " << std::dec << p.redundant << endl;
+	cout << "dropped prefetches = " << std::dec << p.dropped << endl;
+	cout << "prefetch pollution misses = " << std::dec << p.pollution << endl;
+	cout << "prefetch accuracy = " << (p.issued ? (double) p.useful / p.issued : 0.0) << endl;
+	cout << "prefetch coverage = " << (p.useful + misses ? (double) p.useful / (p.useful + misses) : 0.0) << endl;
+	cout << "prefetch lateness = " << (p.useful + p.late ? (double) p.late / (p.useful + p.late) : 0.0) << endl;
+}
+
+string cache::get_policy(bool type){
+	// get a printable string of the policy type
+	if(type){ // type == 1, then this is for the hit policy
+		if(write_hit_policy == WRITE_THROUGH) return "write-through";
+		else return "write-back";
+	} else { // type == 0, for the miss policy 
+		if(write_miss_policy == WRITE_ALLOCATE) return "write-allocate";
+		else return "no-write-allocate";
+	}
+}
+
+double cache::get_average_access_time(){
+	//int hits = ((number_reads - number_read_misses) + (number_writes - number_write_misses));
+	double miss_rate = double (stats.number_read_misses + stats.number_write_misses) / double (stats.number_memory_accesses);
+
+	double avg = miss_rate*cache_miss_penalty + (double)cache_hit_time;
+	if(buffer != NULL){
+		// the misses served by the victim/miss cache cost its hit time instead of the miss penalty
+		double buffer_rate = double (buffer->get_hits()) / double (stats.number_memory_accesses);
+		avg -= buffer_rate * ((double) cache_miss_penalty - (double) buffer->get_hit_time());
+	}
+	//(hits*cache_hit_time + misses*cache_miss_penalty)/(number_memory_accesses);
+	return avg;
+}
+
+unsigned cache::get_hit_time(){
+	return cache_hit_time;
+}
+
+unsigned cache::get_offset_bits(){
+	return offset_bits;
+}
+
+unsigned cache::get_miss_penalty(){
+	return cache_miss_penalty;
+}
+
+bool cache::is_write_through(){
+	return write_hit_policy == WRITE_THROUGH;
+}
+
+bool cache::is_write_allocate(){
+	return write_miss_policy == WRITE_ALLOCATE;
+}
+
+replacement_policy_t cache::get_replacement_policy(){
+	return replacement_type;
+}
+
+unsigned long long cache::num_of_mem_writes(){
+	return mem_writes(stats);
+}
+
+unsigned long long cache::mem_writes(const cache_stats_t &st){
+	unsigned long long count = 0;
+
+	if(write_hit_policy == WRITE_BACK){
+		count += st.write_backs;
+	} else {
+		count += st.write_thrus;
+	}
+
+	if(write_miss_policy == WRITE_ALLOCATE){
+		count += st.write_allocates;
+	} else {
+		count += st.no_write_allocates;
+	}
+
+	return count;
+
+}
+
+void cache::enable_set_statistics(){
+	if(set_counters != NULL) return;
+	set_counters = new set_stats_t[set_count];
+	memset(set_counters, 0, sizeof(set_stats_t) * set_count);
+}
+
+const set_stats_t *cache::get_set_statistics(){
+	return set_counters;
+}
+
+void cache::print_set_statistics(unsigned k){
+	if(set_counters == NULL) return;
+
+	// the "k" sets with the most evictions (then the most misses)
+	vector<unsigned> order(set_count);
+	for(unsigned i = 0; i < set_count; i++) order[i] = i;
+	if(k > set_count) k = set_count;
+	partial_sort(order.begin(), order.begin() + k, order.end(), [this](unsigned a, unsigned b){
+		if(set_counters[a].evictions != set_counters[b].evictions) return set_counters[a].evictions > set_counters[b].evictions;
+		if(set_counters[a].misses != set_counters[b].misses) return set_counters[a].misses > set_counters[b].misses;
+		return a < b;
+	});
+	cout << "hottest sets (by evictions):" << endl;
+	unsigned long long top = 0;
+	for(unsigned i = 0; i < k; i++){
+		const set_stats_t &c = set_counters[order[i]];
+		top += c.evictions;
+		cout << "  set " << std::dec << order[i] << ": accesses = " << c.accesses << ", misses = " << c.misses
+			 << ", evictions = " << c.evictions << ", write-backs = " << c.write_backs << endl;
+	}
+	if(stats.number_evictions != 0)
+		cout << "evictions in the hottest sets = " << std::dec << 100.0 * top / stats.number_evictions << " %" << endl;
+
+	// number of sets with each count of valid lines
+	vector<unsigned> occupancy(cache_associativity + 1, 0);
+	for(unsigned set = 0; set < set_count; set++){
+		unsigned valid = 0;
+		for(unsigned way = 0; way < cache_associativity; way++)
+			valid += tags[(size_t) set * cache_associativity + way] != UNDEFINED;
+		occupancy[valid]++;
+	}
+	cout << "valid lines per set:" << endl;
+	for(unsigned valid = 0; valid <= cache_associativity; valid++){
+		if(occupancy[valid] != 0) cout << "  " << std::dec << valid << " lines: " << occupancy[valid] << " sets" << endl;
+	}
+}
+
+bool cache::dump_set_statistics(const char *filename){
+	if(set_counters == NULL) return false;
+	ofstream out(filename, ios::out | ios::binary | ios::trunc);
+	if(!out.is_open()){
+		cerr << "error: cannot create set statistics file " << filename << endl;
+		return false;
+	}
+	set_dump_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SET_DUMP_MAGIC, sizeof(header.magic));
+	header.version = SET_DUMP_VERSION;
+	header.sets = set_count;
+	header.associativity = cache_associativity;
+	out.write((const char *) &header, sizeof(header));
+	out.write((const char *) set_counters, sizeof(set_stats_t) * set_count);
+	return out.good();
+}
+
+// monotonic time, in seconds
+static double now_seconds(){
+	return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void cache::enable_progress(unsigned long long interval){
+	progress_interval = interval;
+	progress_next = stats.number_memory_accesses + interval;
+	progress_count = stats.number_memory_accesses;
+	progress_time = now_seconds();
+}
+
+void cache::report_progress(unsigned long long accesses){
+	double now = now_seconds();
+	double rate = now > progress_time ? (accesses - progress_count) / (now - progress_time) : 0;
+	cerr << "progress: " << std::dec << accesses << " accesses, " << (unsigned long long) rate << " accesses/s" << endl;
+	progress_count = accesses;
+	progress_time = now;
+	while(progress_next <= accesses) progress_next += progress_interval;
+}
+
+bool cache::enable_interval_stats(unsigned long long interval, const char *filename, bool binary){
+	close_interval_stats();
+	if(interval == 0) return false;
+	sampler = new interval_sampler;
+	if(!sampler->open(filename, interval, binary)){
+		delete sampler;
+		sampler = NULL;
+		return false;
+	}
+	sample_interval = interval;
+	sample_base = stats;
+	sample_buffer_hits = buffer != NULL ? buffer->get_hits() : 0;
+	sample_index = 0;
+	return true;
+}
+
+void cache::close_interval_stats(){
+	if(sampler == NULL) return;
+	if(stats.number_memory_accesses != sample_base.number_memory_accesses) interval_end();
+	sampler->close();
+	delete sampler;
+	sampler = NULL;
+}
+
+inline void cache::interval_check(){
+	if(stats.number_memory_accesses - sample_base.number_memory_accesses == sample_interval) interval_end();
+}
+
+void cache::interval_end(){
+	interval_sample_t sample;
+	cache_stats_t delta;
+	delta.write_thrus = stats.write_thrus - sample_base.write_thrus;
+	delta.write_backs = stats.write_backs - sample_base.write_backs;
+	delta.write_allocates = stats.write_allocates - sample_base.write_allocates;
+	delta.no_write_allocates = stats.no_write_allocates - sample_base.no_write_allocates;
+
+	sample.index = sample_index++;
+	sample.first_access = sample_base.number_memory_accesses;
+	sample.accesses = stats.number_memory_accesses - sample_base.number_memory_accesses;
+	sample.reads = stats.number_reads - sample_base.number_reads;
+	sample.read_misses = stats.number_read_misses - sample_base.number_read_misses;
+	sample.writes = stats.number_writes - sample_base.number_writes;
+	sample.write_misses = stats.number_write_misses - sample_base.number_write_misses;
+	sample.evictions = stats.number_evictions - sample_base.number_evictions;
+	sample.memory_writes = mem_writes(delta);
+
+	// same as get_average_access_time, over the interval
+	double miss_rate = double (sample.read_misses + sample.write_misses) / double (sample.accesses);
+	sample.amat = miss_rate*cache_miss_penalty + (double)cache_hit_time;
+	if(buffer != NULL){
+		unsigned long long hits = buffer->get_hits();
+		sample.amat -= double (hits - sample_buffer_hits) / double (sample.accesses) *
+					   ((double) cache_miss_penalty - (double) buffer->get_hit_time());
+		sample_buffer_hits = hits;
+	}
+
+	sampler->push(sample);
+	sample_base = stats;
+}
+
+unsigned long long cache::get_memory_accesses(){
+	return stats.number_memory_accesses;
+}
+
+unsigned long long cache::get_misses(){
+	return stats.number_read_misses + stats.number_write_misses;
+}
+
+unsigned long long cache::get_evictions(){
+	return stats.number_evictions;
 }
\ No newline at end of file
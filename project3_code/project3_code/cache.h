@@ -1,127 +1,428 @@
-#ifndef CACHE_H_
-#define CACHE_H_
-
-#include <stdio.h>
-#include <stdbool.h>
-#include <string>
-#include <sstream>
-#include <iostream>
-#include <fstream>
-
-using namespace std;
-
-#define UNDEFINED 0xFFFFFFFFFFFFFFFF //constant used for initialization
-
-typedef enum {WRITE_BACK, WRITE_THROUGH, WRITE_ALLOCATE, NO_WRITE_ALLOCATE} write_policy_t; 
-
-typedef enum {HIT, MISS} access_type_t;
-
-typedef unsigned long long address_t; //memory address type
-
-typedef struct{
-	unsigned lru;	// keeps track of lru
-	bool dirty;		// keeps track of valid
-	unsigned long long tag;	// the tag
-} cache_block_t;
-
-class cache{
-
-	/* Add the data members required by your simulator's implementation here */
-	unsigned cache_size; 				// cache size (in bytes)
-    unsigned cache_associativity;     	// cache associativity (fully-associative caches not considered)
-	unsigned cache_line_size;         	// cache block size (in bytes)
-	write_policy_t write_hit_policy;  	// write-back or write-through
-	write_policy_t write_miss_policy; 	// write-allocate or no-write-allocate
-	unsigned cache_hit_time;			// cache hit time (in clock cycles)
-	unsigned cache_miss_penalty;		// cache miss penalty (in clock cycles)	
-	unsigned cache_address_width;  		// number of bits in memory address
-
-	// #sets = #blocks/assoc = size / (block-sz * assoc)
-	unsigned set_count; 
-
-	// bit counts
-	unsigned idx_bits;
-	unsigned offset_bits;
-	unsigned tag_bits;
-
-	// bit masks
-	unsigned long long idx_mask;
-	unsigned long long offset_mask;
-	unsigned long long tag_mask;
-
-	// 2D array to store cache information
-	cache_block_t **cache_s;
-
-	/* number of memory accesses processed */
-	unsigned number_memory_accesses;
-	unsigned number_reads;
-	unsigned number_read_misses;
-	unsigned number_writes;
-	unsigned number_write_misses;
-	unsigned number_evictions;
-	unsigned number_mem_writes;
-
-	unsigned write_thrus;
-	unsigned write_backs;
-	unsigned write_allocates;
-	unsigned no_write_allocates;
-
-	/* trace file input stream */	
-	ifstream stream;
-
-
-public:
-
-	/* Instantiates the cache simulator */
-	cache(
-		unsigned size, 					// cache size (in bytes)
-        unsigned associativity,     	// cache associativity (fully-associative caches not considered)
-	    unsigned line_size,         	// cache block size (in bytes)
-	    write_policy_t wr_hit_policy,  	// write-back or write-through
-	    write_policy_t wr_miss_policy, 	// write-allocate or no-write-allocate
-	    unsigned hit_time,				// cache hit time (in clock cycles)
-	    unsigned miss_penalty,			// cache miss penalty (in clock cycles)	
-	    unsigned address_width          // number of bits in memory address
-	);	
-	
-	// de-allocates the cache simulator
-	~cache();
-
-	// loads the trace file (with name "filename") so that it can be used by the "run" function  
-	void load_trace(const char *filename);
-
-	// processes "num_memory_accesses" memory accesses (i.e., entries) from the input trace 
-	// if "num_memory_accesses=0" (default), then it processes the trace to completion 
-	void run(unsigned num_memory_accesses=0);
-	
-	// processes a read operation and returns hit/miss
-	access_type_t read(address_t address);
-	
-	// processes a write operation and returns hit/miss
-	access_type_t write(address_t address);
-
-	// returns the next block to be evicted from the cache
-	unsigned evict(unsigned set);
-	
-	// prints the cache configuration
-	void print_configuration();
-	
-	// prints the execution statistics
-	void print_statistics();
-
-	//prints the metadata information (including "dirty" but, when applicable) for all valid cache entries  
-	void print_tag_array();
-
-	//gets the write policy
-	string get_policy(bool type);
-
-	//get average access time
-	double get_average_access_time();
-
-	//get number of memory writes
-	unsigned num_of_mem_writes();
-
-
-};
-
-#endif /*CACHE_H_*/
+#ifndef CACHE_H_
+#define CACHE_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include "trace.h"
+#include "trace_prefetch.h"
+#include "replacement.h"
+#include "prefetcher.h"
+#include "victim_cache.h"
+#include "interval_sampler.h"
+
+using namespace std;
+
+#define UNDEFINED 0xFFFFFFFFFFFFFFFF //constant used for initialization
+
+#define CACHE_BATCH 256 // addresses decoded at once by the batched accesses
+
+#define SLICE_PROBE 8 // run_sliced: each slice also simulates this fraction (1/8) of the next one to estimate the error
+
+#define INDEX_MIN_WAYS 32 // single-set caches with more ways find tags with a hash index instead of a scan
+
+typedef enum {WRITE_BACK, WRITE_THROUGH, WRITE_ALLOCATE, NO_WRITE_ALLOCATE} write_policy_t; 
+
+typedef enum {HIT, MISS} access_type_t;
+
+// execution statistics (kept per shard by run_parallel and merged at the end)
+typedef struct{
+	/* number of memory accesses processed */
+	unsigned long long number_memory_accesses;
+	unsigned long long number_reads;
+	unsigned long long number_read_misses;
+	unsigned long long number_writes;
+	unsigned long long number_write_misses;
+	unsigned long long number_evictions;
+	unsigned long long number_mem_writes;
+	unsigned long long write_thrus;
+	unsigned long long write_backs;
+	unsigned long long write_allocates;
+	unsigned long long no_write_allocates;
+} cache_stats_t;
+
+// line evicted by an access (see the "access" and "fill" versions taking a cache_victim_t)
+typedef struct{
+	bool valid;			// false if the access did not evict any line
+	address_t address;	// address of the first byte of the evicted line
+	bool dirty;			// the line must be written back (write-back caches only)
+} cache_victim_t;
+
+// counters of one set (see enable_set_statistics)
+typedef struct{
+	uint64_t accesses;
+	uint64_t misses;
+	uint64_t evictions;
+	uint64_t write_backs;	// dirty lines written back to memory by the evictions of the set
+} set_stats_t;
+
+/* Binary per-set dump (see dump_set_statistics)
+ * header (set_dump_header_t) followed by one set_stats_t per set, in set order (little-endian) */
+#define SET_DUMP_MAGIC "CSET"
+#define SET_DUMP_VERSION 2
+
+typedef struct{
+	char magic[4];			// SET_DUMP_MAGIC
+	uint32_t version;		// SET_DUMP_VERSION
+	uint32_t sets;			// number of set_stats_t records
+	uint32_t associativity;
+} set_dump_header_t;
+
+#define SET_TOP_K 10 // sets listed by print_statistics when the per-set counters are enabled
+
+/* Checkpoint file (see save_checkpoint)
+ * header (checkpoint_header_t), the statistics (cache_stats_t), the tag (64-bit) and the dirty bit
+ * (one byte) of each line, the free ways of an indexed single set (save_vector), the state of the
+ * replacement policy, and the per-set counters (if CHECKPOINT_SET_STATS) */
+#define CHECKPOINT_MAGIC "CCKP"
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_SET_STATS 0x1		// the per-set counters follow the replacement state
+#define CHECKPOINT_POSITION 0x2			// "position" is the decoder state of the trace
+
+typedef struct{
+	char magic[4];				// CHECKPOINT_MAGIC
+	uint32_t version;			// CHECKPOINT_VERSION
+	uint32_t flags;				// CHECKPOINT_*
+	uint32_t size;				// geometry and policies of the cache (the timings are not checked)
+	uint32_t associativity;
+	uint32_t line_size;
+	uint32_t address_width;
+	uint32_t write_hit_policy;
+	uint32_t write_miss_policy;
+	uint32_t replacement;
+	uint64_t trace_records;		// records of the loaded trace simulated by run/run_parallel
+	uint64_t future_index;		// next record of the whole trace (OPT)
+	trace_position_t position;	// where the trace resumes (CHECKPOINT_POSITION)
+} checkpoint_header_t;
+
+class miss_classifier;
+
+class cache{
+
+	/* Add the data members required by your simulator's implementation here */
+	unsigned cache_size; 				// cache size (in bytes)
+    unsigned cache_associativity;     	// cache associativity (number of lines if fully-associative)
+	bool fully_associative;				// created with associativity 0
+	unsigned cache_line_size;         	// cache block size (in bytes)
+	write_policy_t write_hit_policy;  	// write-back or write-through
+	write_policy_t write_miss_policy; 	// write-allocate or no-write-allocate
+	unsigned cache_hit_time;			// cache hit time (in clock cycles)
+	unsigned cache_miss_penalty;		// cache miss penalty (in clock cycles)	
+	unsigned cache_address_width;  		// number of bits in memory address
+
+	// #sets = #blocks/assoc = size / (block-sz * assoc)
+	unsigned set_count; 
+
+	// bit counts
+	unsigned idx_bits;
+	unsigned offset_bits;
+	unsigned tag_bits;
+
+	// bit masks
+	unsigned long long idx_mask;
+	unsigned long long offset_mask;
+	unsigned long long tag_mask;
+
+	// tag store, set-major: line "way" of set "set" is at index set * cache_associativity + way
+	unsigned long long *tags;	// tag of each line (UNDEFINED if the line is invalid)
+	bool *dirty;				// dirty bit of each line
+
+	// single set with many ways: open-addressing hash index of the valid lines, and the free ways
+	// (the next one filled is the last)
+	unsigned *tag_index;		// way + 1 of a valid line, 0 for an empty slot (NULL if the ways are scanned)
+	unsigned index_mask;		// number of slots - 1
+	vector<unsigned> free_ways;
+
+	// replacement policy (and its per-set state)
+	replacement_policy_t replacement_type;
+	replacement_policy *replacement;
+
+	/* execution statistics */
+	cache_stats_t stats;
+	miss_classifier *classifier;	// 3C classification of the misses (NULL if not enabled)
+	prefetch_state_t *pf;			// hardware prefetching (NULL if not enabled)
+	victim_cache *buffer;			// victim cache or miss cache (NULL if not attached)
+	set_stats_t *set_counters;		// per-set counters (NULL if not enabled)
+
+	/* interval statistics (see enable_interval_stats) */
+	interval_sampler *sampler;		// writer of the interval samples (NULL if not enabled)
+	unsigned long long sample_interval;	// memory accesses per interval
+	cache_stats_t sample_base;		// statistics at the start of the current interval
+	unsigned long long sample_buffer_hits;	// victim/miss cache hits at the start of the current interval
+	uint64_t sample_index;			// number of the current interval
+
+	/* progress reporting (see enable_progress) */
+	unsigned long long progress_interval;	// memory accesses between two reports (0: disabled)
+	unsigned long long progress_next;		// memory accesses at the next report
+	unsigned long long progress_count;		// memory accesses at the last report
+	double progress_time;					// time of the last report (in seconds)
+
+	/* time-sliced simulation (see run_sliced) */
+	unsigned slice_count;				// slices of the last run_sliced (0: not used)
+	unsigned long long slice_warmup;	// warm-up accesses of each slice
+	unsigned long long slice_error;		// estimated misses miscounted by the slicing
+
+	/* trace file input (text or binary) */
+	trace_reader trace;
+	trace_prefetcher *trace_ahead;	// decodes the trace on a background thread (NULL: "trace" is used)
+	unsigned long long trace_records;	// records of the loaded trace decoded so far
+	string trace_filename;			// loaded trace (empty: none), reopened to rewind it
+
+	/* whole trace with its next-use distances, loaded instead of "trace" for the OPT policy */
+	trace_buffer *future;
+	size_t future_index;	// next record of "future" to simulate
+
+	// versions of access/read/write/evict that update the given statistics (one set per shard)
+	// and, if "victim" is not NULL, report the line evicted
+	access_type_t access(bool is_write, address_t address, cache_stats_t &st, cache_victim_t *victim=NULL);
+	access_type_t read(address_t address, cache_stats_t &st, cache_victim_t *victim=NULL);
+	access_type_t write(address_t address, cache_stats_t &st, cache_victim_t *victim=NULL);
+	unsigned evict(unsigned set, cache_stats_t &st, cache_victim_t *victim=NULL);
+
+	// decodes up to "max" records of the loaded trace (through "trace_ahead", if any)
+	unsigned read_trace(trace_record_t *records, unsigned max);
+
+	// prefetching: a demand hit to a prefetched line, the bookkeeping after each demand access,
+	// the training of the prefetcher and the issue of its requests, and the fill of a prefetched line
+	inline void prefetch_hit(size_t line);
+	void prefetch_access(address_t address, access_type_t result);
+	void prefetch_issue(address_t block, access_type_t result);
+	void prefetch_fill(address_t block);
+	void print_prefetch_statistics();
+
+	// looks up the line missed in "set" in the victim/miss cache; returns true on a hit
+	inline bool buffer_lookup(unsigned set, unsigned long long tag, bool &was_dirty);
+
+	// interval statistics: ends the current interval if it is complete, and queues the sample of
+	// the current interval (even if it is not complete)
+	inline void interval_check();
+	void interval_end();
+
+	// prints the number of memory accesses simulated and the rate since the last report
+	void report_progress(unsigned long long accesses);
+
+	// memory writes counted in the given statistics, according to the write policies
+	unsigned long long mem_writes(const cache_stats_t &st);
+
+	// returns the set, the tag and the way (cache_associativity if absent) of an address
+	inline unsigned locate(address_t address, unsigned &set, unsigned long long &tag);
+
+	// read/write of a decoded address
+	inline access_type_t read_line(unsigned set, unsigned long long tag, cache_stats_t &st, cache_victim_t *victim);
+	inline access_type_t write_line(unsigned set, unsigned long long tag, cache_stats_t &st, cache_victim_t *victim);
+
+	// decodes the set and the tag of "count" (at most CACHE_BATCH) addresses
+	void decode_batch(const address_t *addresses, unsigned count, unsigned long long *sets, unsigned long long *keys);
+
+	// read_batch/write_batch: "count" accesses of the same kind
+	void access_batch(bool is_write, const address_t *addresses, size_t count, access_type_t *results);
+
+	// returns the way of "set" holding "tag", or cache_associativity if there is none
+	inline unsigned find_way(unsigned set, unsigned long long tag);
+
+	// stores "tag" (UNDEFINED: invalid) in a line, keeping the tag index up to date
+	inline void set_line(size_t line, unsigned long long tag);
+
+	// first slot of the tag index to probe for "tag"
+	inline unsigned index_slot(unsigned long long tag);
+
+
+public:
+
+	/* Instantiates the cache simulator */
+	cache(
+		unsigned size, 					// cache size (in bytes)
+        unsigned associativity,     	// cache associativity (0: fully-associative)
+	    unsigned line_size,         	// cache block size (in bytes)
+	    write_policy_t wr_hit_policy,  	// write-back or write-through
+	    write_policy_t wr_miss_policy, 	// write-allocate or no-write-allocate
+	    unsigned hit_time,				// cache hit time (in clock cycles)
+	    unsigned miss_penalty,			// cache miss penalty (in clock cycles)	
+	    unsigned address_width,         // number of bits in memory address
+	    replacement_policy_t policy=LRU	// replacement policy
+	);	
+	
+	// de-allocates the cache simulator
+	~cache();
+
+	// loads the trace file (with name "filename") so that it can be used by the "run" function  
+	// both text traces and binary traces (see trace.h) are accepted
+	// with the OPT policy, the whole trace is decoded and indexed by next use
+	// if "prefetch", a background thread decodes the trace while "run" simulates it
+	void load_trace(const char *filename, bool prefetch=false);
+
+	// processes "num_memory_accesses" memory accesses (i.e., entries) from the input trace 
+	// if "num_memory_accesses=0" (default), then it processes the trace to completion 
+	void run(unsigned long long num_memory_accesses=0);
+	
+	// same as "run", but the sets are split in "threads" contiguous ranges simulated in parallel
+	// (0: one thread per hardware thread); the statistics are identical to those of "run"
+	// (policies whose sets share state, like DRRIP, always run serially)
+	void run_parallel(unsigned threads, unsigned long long num_memory_accesses=0);
+
+	// processes the "count" memory accesses of an in-memory trace in "slices" contiguous slices,
+	// simulated in parallel (on "threads" threads, 0: one per hardware thread) on cold copies of the
+	// cache; before the accesses it counts, each slice but the first simulates the last "warmup"
+	// accesses of the previous slice (at most the whole slice) to warm its copy up
+	// the statistics of the slices are added to those of the cache (whose contents are unchanged);
+	// the result differs from a serial run by the misses that the warm-up does not reproduce; to
+	// estimate the error, each slice also simulates the first 1/SLICE_PROBE of the next one, and
+	// the misses there are compared with those of the next slice (see get_slicing_error)
+	// (caches with a classifier, prefetcher, buffer, interval or per-set statistics run serially;
+	// the OPT policy needs the next-use distances of a loaded trace, so it is not supported here)
+	void run_sliced(const trace_record_t *records, size_t count, unsigned slices,
+					unsigned long long warmup, unsigned threads=0);
+
+	// same as above, with the rest of the loaded trace (decoded into memory first)
+	// (with the OPT policy, the loaded trace is simulated serially by "run")
+	void run_sliced(unsigned slices, unsigned long long warmup, unsigned threads=0);
+
+	// estimated number of misses miscounted by the last run_sliced (printed by print_statistics)
+	unsigned long long get_slicing_error();
+
+	// writes the state of the cache (tag array, dirty bits, replacement state, statistics, per-set
+	// counters, and the position in the loaded trace) to "filename" (format above)
+	// not supported with a miss classifier, a prefetcher or a victim/miss cache
+	// returns false if the state cannot be saved
+	bool save_checkpoint(const char *filename);
+
+	// restores a state saved by save_checkpoint into a cache of the same geometry and policies
+	// (its hit time and miss penalty may differ); load the same trace first, so that "run"
+	// resumes after the last access simulated before the checkpoint
+	// returns false if the file cannot be read or does not match the cache
+	bool load_checkpoint(const char *filename);
+
+	// processes the "count" memory accesses of an in-memory trace (e.g., a trace_buffer)
+	// (not with the OPT policy, which needs the next-use distances of a loaded trace)
+	void run(const trace_record_t *records, size_t count);
+
+	// processes one memory access of the trace (read or write), updates the statistics and returns hit/miss
+	access_type_t access(bool is_write, address_t address);
+
+	// same as "access", and reports in "victim" the line evicted (if any)
+	access_type_t access(bool is_write, address_t address, cache_victim_t &victim);
+
+	// processes "count" memory accesses in order, as many calls to "access" would
+	// the set and tag of a block of addresses are decoded at once, the counters are updated once
+	// per block, and the hit/miss of access i is stored in results[i] (unless "results" is NULL)
+	void access_batch(const trace_record_t *records, size_t count, access_type_t *results=NULL);
+
+	// same as "access_batch", for reads only and writes only
+	void read_batch(const address_t *addresses, size_t count, access_type_t *results=NULL);
+	void write_batch(const address_t *addresses, size_t count, access_type_t *results=NULL);
+
+	// processes a read operation and returns hit/miss
+	access_type_t read(address_t address);
+	
+	// processes a write operation and returns hit/miss
+	access_type_t write(address_t address);
+
+	// returns the next block to be evicted from the cache
+	unsigned evict(unsigned set);
+
+	/* operations used by a cache hierarchy (they are not counted as memory accesses) */
+
+	// returns true if the line holding "address" is in the cache
+	bool probe(address_t address);
+
+	// appends the address of the first byte of each valid line to "addresses"
+	void get_lines(vector<address_t> &addresses);
+
+	// inserts the line holding "address" (e.g., a line written back or evicted by the level above)
+	// the line is marked dirty if "is_dirty" (write-back caches only); reports the line evicted
+	void fill(address_t address, bool is_dirty, cache_victim_t &victim);
+
+	// removes the line holding "address"; returns false if it is not in the cache
+	// "was_dirty" tells if the line had to be written back
+	bool invalidate(address_t address, bool &was_dirty);
+
+	// read access that removes the line on a hit (exclusive hierarchies move the line to the level
+	// above) and does not allocate on a miss; counted as a read
+	access_type_t extract(address_t address, bool &was_dirty);
+	
+	// prints the cache configuration
+	void print_configuration();
+	
+	// prints the execution statistics
+	void print_statistics();
+
+	// classifies the following misses as compulsory, capacity or conflict (see miss_classifier.h)
+	// the counts are printed by print_statistics; the simulation of a classified cache is serial
+	void enable_miss_classification();
+	miss_classifier *get_miss_classifier();
+
+	// prefetches into the cache with the given prefetcher, trained on the following demand misses
+	// "degree": blocks prefetched per training event (adjusted to the measured accuracy if "throttle")
+	// "latency": demand accesses between a prefetch and the fill of its line (0: immediate)
+	// the statistics are printed by print_statistics; the simulation of a prefetching cache is serial
+	void enable_prefetcher(prefetcher_t type, unsigned degree=1, bool throttle=false, unsigned latency=0);
+	prefetch_stats_t get_prefetch_stats();
+
+	// attaches a fully-associative victim cache (or, if "miss_cache", a miss cache) of "entries"
+	// lines, probed on the misses of the cache and serving its hits in "hit_time" cycles
+	// the misses of the cache are still counted as misses; get_average_access_time accounts for
+	// the hits of the buffer. The simulation of a cache with a buffer is serial
+	void attach_victim_cache(unsigned entries, bool miss_cache=false, unsigned hit_time=1);
+	victim_cache *get_victim_cache();
+
+	// keeps per-set counters of the following accesses, misses, evictions and write-backs
+	// (run_parallel is still parallel: its shards update disjoint sets)
+	void enable_set_statistics();
+	const set_stats_t *get_set_statistics();	// set_count counters, NULL if not enabled
+
+	// prints the "k" sets with the most evictions and the histogram of the valid lines per set
+	// (also printed by print_statistics, with k=SET_TOP_K)
+	void print_set_statistics(unsigned k=SET_TOP_K);
+
+	// writes the per-set counters to "filename" in the format above (e.g., to plot a heatmap)
+	// returns false if they are not enabled or the file cannot be created
+	bool dump_set_statistics(const char *filename);
+
+	// every "interval" memory accesses simulated by run/run_parallel, prints to cerr the number of
+	// accesses and the accesses/second since the previous report (0: disabled)
+	void enable_progress(unsigned long long interval);
+
+	// every "interval" memory accesses, writes the counters of the interval (accesses, reads, misses,
+	// evictions, memory writes and average access time) to "filename", as CSV or, if "binary", in
+	// the format of interval_sampler.h; the file is written by a background thread, through a ring
+	// of SAMPLER_RING samples: if the writer falls that far behind, the simulation waits for it
+	// (no sample is dropped). The simulation of a sampled cache is serial.
+	// Returns false if the file cannot be created
+	bool enable_interval_stats(unsigned long long interval, const char *filename, bool binary=false);
+
+	// writes the last (partial) interval and closes the file (also done by the destructor)
+	void close_interval_stats();
+
+	//prints the metadata information (including "dirty" but, when applicable) for all valid cache entries  
+	void print_tag_array();
+
+	//gets the write policy
+	string get_policy(bool type);
+
+	//get average access time
+	double get_average_access_time();
+
+	//get hit time, miss penalty and write policies
+	unsigned get_hit_time();
+	unsigned get_offset_bits();	// log2 of the line size (the block of an address is address >> offset_bits)
+	unsigned get_miss_penalty();
+	bool is_write_through();
+	bool is_write_allocate();
+	replacement_policy_t get_replacement_policy();
+
+	//get number of memory writes
+	unsigned long long num_of_mem_writes();
+
+	//get number of memory accesses, misses (read and write) and evictions
+	unsigned long long get_memory_accesses();
+	unsigned long long get_misses();
+	unsigned long long get_evictions();
+
+
+};
+
+#endif /*CACHE_H_*/
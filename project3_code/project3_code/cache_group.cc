@@ -0,0 +1,59 @@
+#include "cache_group.h"
+
+using namespace std;
+
+cache_group::cache_group(){
+	number_memory_accesses = 0;
+}
+
+cache_group::~cache_group(){
+	for(unsigned i = 0; i < caches.size(); i++) delete caches[i];
+}
+
+unsigned cache_group::add(const cache_config_t &config){
+	caches.push_back(new cache(config.size,
+							   config.associativity,
+							   config.line_size,
+							   config.wr_hit_policy,
+							   config.wr_miss_policy,
+							   config.hit_time,
+							   config.miss_penalty,
+							   config.address_width,
+							   config.replacement));
+	return caches.size() - 1;
+}
+
+unsigned cache_group::size(){
+	return caches.size();
+}
+
+cache *cache_group::get(unsigned index){
+	return caches[index];
+}
+
+void cache_group::load_trace(const char *filename){
+	trace.open(filename);
+}
+
+void cache_group::run(unsigned long long num_entries){
+	unsigned long long first_access = number_memory_accesses;
+
+	while(num_entries == 0 || number_memory_accesses - first_access < num_entries){
+
+		// decode a block of records once
+		unsigned n = 0;
+		unsigned max = GROUP_BLOCK;
+		if(num_entries != 0 && num_entries - (number_memory_accesses - first_access) < max)
+			max = num_entries - (number_memory_accesses - first_access);
+		while(n < max && trace.next(block[n])) n++;
+		if(n == 0) break;
+
+		// replay the block on each cache in turn, so its tag array stays in the host cache
+		for(unsigned c = 0; c < caches.size(); c++){
+			caches[c]->access_batch(block, n);
+		}
+
+		number_memory_accesses += n;
+		if(n < max) break; // end of the trace
+	}
+}
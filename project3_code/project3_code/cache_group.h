@@ -0,0 +1,64 @@
+#ifndef CACHE_GROUP_H_
+#define CACHE_GROUP_H_
+
+#include <vector>
+#include "cache.h"
+
+using namespace std;
+
+#define GROUP_BLOCK 4096 // number of trace records decoded before dispatching them to the caches
+
+// parameters of one cache configuration (see the cache constructor)
+typedef struct{
+	unsigned size; 					// cache size (in bytes)
+	unsigned associativity;     	// cache associativity
+	unsigned line_size;         	// cache block size (in bytes)
+	write_policy_t wr_hit_policy;  	// write-back or write-through
+	write_policy_t wr_miss_policy; 	// write-allocate or no-write-allocate
+	unsigned hit_time;				// cache hit time (in clock cycles)
+	unsigned miss_penalty;			// cache miss penalty (in clock cycles)
+	unsigned address_width;         // number of bits in memory address
+	replacement_policy_t replacement;	// replacement policy (LRU if omitted)
+} cache_config_t;
+
+/* Simulates several cache configurations with a single pass over the trace:
+ * each trace record is decoded once and dispatched to every cache of the group */
+class cache_group{
+
+	vector<cache *> caches;
+
+	/* trace file input (text or binary) */
+	trace_reader trace;
+
+	/* decoded records not yet dispatched */
+	trace_record_t block[GROUP_BLOCK];
+
+	/* number of memory accesses processed by each cache */
+	unsigned long long number_memory_accesses;
+
+public:
+
+	cache_group();
+
+	// de-allocates all the caches of the group
+	~cache_group();
+
+	// adds a cache with the given configuration to the group and returns its index
+	// (not with the OPT policy, which needs the whole trace in advance)
+	unsigned add(const cache_config_t &config);
+
+	// returns the number of caches in the group
+	unsigned size();
+
+	// returns the cache with the given index (e.g., to print its configuration or statistics)
+	cache *get(unsigned index);
+
+	// loads the trace file (with name "filename") so that it can be used by the "run" function
+	void load_trace(const char *filename);
+
+	// processes "num_memory_accesses" memory accesses from the input trace on every cache
+	// if "num_memory_accesses=0" (default), then it processes the trace to completion
+	void run(unsigned long long num_memory_accesses=0);
+};
+
+#endif /*CACHE_GROUP_H_*/
@@ -0,0 +1,295 @@
+#include "cache_hierarchy.h"
+#include <iostream>
+#include <unordered_map>
+
+using namespace std;
+
+static const char *inclusion_names[] = {"non-inclusive", "inclusive", "exclusive"};
+
+static cache *new_cache(const cache_config_t &config){
+	return new cache(config.size,
+					 config.associativity,
+					 config.line_size,
+					 config.wr_hit_policy,
+					 config.wr_miss_policy,
+					 config.hit_time,
+					 config.miss_penalty,
+					 config.address_width,
+					 config.replacement);
+}
+
+static void clear_level(cache_level_t &level, cache *c){
+	level.c = c;
+	level.demand_accesses = 0;
+	level.demand_misses = 0;
+	level.write_backs_in = 0;
+	level.back_invalidations = 0;
+}
+
+cache_hierarchy::cache_hierarchy(inclusion_policy_t inclusion){
+	this->inclusion = inclusion;
+	clear_level(icache, NULL);
+	memory_reads = 0;
+	memory_writes = 0;
+	number_memory_accesses = 0;
+}
+
+cache_hierarchy::~cache_hierarchy(){
+	for(unsigned i = 0; i < levels.size(); i++) delete levels[i].c;
+	delete icache.c;
+}
+
+unsigned cache_hierarchy::add_level(const cache_config_t &config){
+	cache_level_t level;
+	clear_level(level, new_cache(config));
+	levels.push_back(level);
+	return levels.size() - 1;
+}
+
+void cache_hierarchy::set_instruction_cache(const cache_config_t &config){
+	delete icache.c;
+	clear_level(icache, new_cache(config));
+}
+
+unsigned cache_hierarchy::size(){
+	return levels.size();
+}
+
+cache *cache_hierarchy::get(unsigned index){
+	return levels[index].c;
+}
+
+cache *cache_hierarchy::get_instruction_cache(){
+	return icache.c;
+}
+
+void cache_hierarchy::load_trace(const char *filename){
+	trace.open(filename);
+}
+
+void cache_hierarchy::run(unsigned long long num_entries){
+	unsigned long long first_access = number_memory_accesses;
+	trace_record_t rec;
+
+	while(trace.next(rec)){
+		access(rec.write, rec.address);
+		if(num_entries != 0 && number_memory_accesses - first_access == num_entries) break;
+	}
+}
+
+void cache_hierarchy::access(bool is_write, address_t address){
+	number_memory_accesses++;
+	access_level(levels[0], 1, is_write, address, true);
+}
+
+void cache_hierarchy::fetch(address_t address){
+	number_memory_accesses++;
+	if(icache.c == NULL) access_level(levels[0], 1, false, address, true);
+	else access_level(icache, 1, false, address, true);
+}
+
+void cache_hierarchy::access_level(cache_level_t &level, unsigned next, bool is_write, address_t address, bool demand){
+	cache_victim_t victim;
+	access_type_t result = level.c->access(is_write, address, victim);
+
+	if(demand){
+		level.demand_accesses++;
+		if(result == MISS) level.demand_misses++;
+	}
+
+	// bring the missing line from below; the victim goes down first (so that an inclusive lower
+	// level still holds it), except in an exclusive hierarchy (where it could displace the line)
+	bool fetch = result == MISS && (!is_write || level.c->is_write_allocate());
+	if(inclusion == EXCLUSIVE){
+		if(fetch) promote(level, next, address);
+		if(victim.valid) evicted(level, next, victim);
+	}else{
+		if(victim.valid) evicted(level, next, victim);
+		if(fetch) forward(next, false, address, demand);
+	}
+
+	// write-through (or not allocated) writes continue to the next level
+	if(is_write && (level.c->is_write_through() || (result == MISS && !level.c->is_write_allocate()))){
+		if(inclusion == EXCLUSIVE) write_down(next, address);
+		else forward(next, true, address, false);
+	}
+}
+
+// exclusive: a write passed down updates the lower level holding the line (which does not allocate
+// on a hit), or memory; allocating it below would copy a line that may be cached above
+void cache_hierarchy::write_down(unsigned next, address_t address){
+	for(unsigned i = next; i < levels.size(); i++){
+		if(levels[i].c->probe(address)){
+			access_level(levels[i], i + 1, true, address, false);
+			return;
+		}
+	}
+	memory_writes++;
+}
+
+void cache_hierarchy::forward(unsigned next, bool is_write, address_t address, bool demand){
+	if(next == levels.size()){
+		if(is_write) memory_writes++;
+		else memory_reads++;
+		return;
+	}
+	access_level(levels[next], next + 1, is_write, address, demand);
+}
+
+// exclusive: the first lower level holding the line gives it to "level"
+void cache_hierarchy::promote(cache_level_t &level, unsigned next, address_t address){
+	for(unsigned i = next; i < levels.size(); i++){
+		bool was_dirty;
+		access_type_t result = levels[i].c->extract(address, was_dirty);
+		levels[i].demand_accesses++;
+		if(result == HIT){
+			if(was_dirty){
+				// a write-through level only holds clean lines: the dirty data goes to memory (a lower
+				// level cannot take it without holding the line twice)
+				if(level.c->is_write_through()) memory_writes++;
+				else{
+					cache_victim_t none;
+					level.c->fill(address, true, none);
+				}
+			}
+			return;
+		}
+		levels[i].demand_misses++;
+	}
+	memory_reads++;
+}
+
+// a line written back (or, if exclusive, evicted) by the level above enters levels[next]
+void cache_hierarchy::place(unsigned next, address_t address, bool is_dirty){
+	if(next == levels.size()){
+		if(is_dirty) memory_writes++;
+		return;
+	}
+	cache_level_t &level = levels[next];
+	cache_victim_t victim;
+	if(is_dirty) level.write_backs_in++;
+	level.c->fill(address, is_dirty, victim);
+	if(victim.valid) evicted(level, next + 1, victim);
+	if(is_dirty && level.c->is_write_through()) place(next + 1, address, true);
+}
+
+void cache_hierarchy::evicted(cache_level_t &level, unsigned next, cache_victim_t &victim){
+
+	// inclusive: the levels above L(next-1) cannot keep the line (their dirty data goes down with it)
+	if(inclusion == INCLUSIVE && next > 1){
+		for(unsigned i = 0; i < next - 1; i++){
+			bool was_dirty;
+			if(levels[i].c->invalidate(victim.address, was_dirty)){
+				levels[i].back_invalidations++;
+				if(was_dirty) victim.dirty = true;
+			}
+		}
+		bool was_dirty;
+		if(icache.c != NULL && icache.c->invalidate(victim.address, was_dirty)){
+			icache.back_invalidations++;
+			if(was_dirty) victim.dirty = true;
+		}
+	}
+
+	if(inclusion == EXCLUSIVE) place(next, victim.address, victim.dirty);
+	else if(victim.dirty) place(next, victim.address, true);
+}
+
+void cache_hierarchy::print_configuration(){
+	cout << "CACHE HIERARCHY" << endl;
+	cout << "inclusion policy = " << inclusion_names[inclusion] << endl;
+	cout << "levels = " << std::dec << levels.size() << endl;
+	if(icache.c != NULL){
+		cout << "L1I" << endl;
+		icache.c->print_configuration();
+	}
+	for(unsigned i = 0; i < levels.size(); i++){
+		cout << "L" << std::dec << i + 1 << (i == 0 && icache.c != NULL ? "D" : "") << endl;
+		levels[i].c->print_configuration();
+	}
+}
+
+void cache_hierarchy::print_level(const char *name, cache_level_t &level){
+	cout << name << endl;
+	level.c->print_statistics();
+	cout << "demand accesses = " << std::dec << level.demand_accesses << endl;
+	cout << "demand misses = " << std::dec << level.demand_misses << endl;
+	cout << "write-backs received = " << std::dec << level.write_backs_in << endl;
+	if(inclusion == INCLUSIVE) cout << "back-invalidations = " << std::dec << level.back_invalidations << endl;
+}
+
+void cache_hierarchy::print_statistics(){
+	cout << "HIERARCHY STATISTICS" << endl;
+	if(icache.c != NULL) print_level("L1I", icache);
+	for(unsigned i = 0; i < levels.size(); i++){
+		string name = "L" + to_string(i + 1) + (i == 0 && icache.c != NULL ? "D" : "");
+		print_level(name.c_str(), levels[i]);
+	}
+	cout << "memory reads = " << std::dec << memory_reads << endl;
+	cout << "memory writes = " << std::dec << memory_writes << endl;
+	cout << "average memory access time = " << get_average_access_time() << endl;
+	if(icache.c != NULL) cout << "average fetch time = " << get_average_fetch_time() << endl;
+}
+
+// local demand miss rate of a level
+static double miss_rate(const cache_level_t &level){
+	if(level.demand_accesses == 0) return 0;
+	return (double) level.demand_misses / (double) level.demand_accesses;
+}
+
+// time to serve a demand miss of the level above levels[first]
+static double lower_access_time(const vector<cache_level_t> &levels, unsigned first){
+	double time = levels.back().c->get_miss_penalty();	// memory latency
+	for(unsigned i = levels.size(); i-- > first;)
+		time = levels[i].c->get_hit_time() + miss_rate(levels[i]) * time;
+	return time;
+}
+
+double cache_hierarchy::get_average_access_time(){
+	return lower_access_time(levels, 0);
+}
+
+double cache_hierarchy::get_average_fetch_time(){
+	if(icache.c == NULL) return get_average_access_time();
+	return icache.c->get_hit_time() + miss_rate(icache) * lower_access_time(levels, 1);
+}
+
+unsigned long long cache_hierarchy::check_inclusion(){
+	if(inclusion == NON_INCLUSIVE || levels.empty()) return 0;
+
+	// lines of each level (the L1I lines are L1 lines)
+	vector< vector<address_t> > lines(levels.size());
+	for(unsigned i = 0; i < levels.size(); i++) levels[i].c->get_lines(lines[i]);
+	if(icache.c != NULL) icache.c->get_lines(lines[0]);
+
+	unsigned long long violations = 0;
+	if(inclusion == EXCLUSIVE){
+		// level of each line: a line of a level must not be in any other level
+		unordered_map<address_t, unsigned> owner;
+		for(unsigned i = 0; i < levels.size(); i++){
+			for(size_t j = 0; j < lines[i].size(); j++){
+				pair<unordered_map<address_t, unsigned>::iterator, bool> r = owner.insert(make_pair(lines[i][j], i));
+				if(!r.second && r.first->second != i) violations++;
+			}
+		}
+		return violations;
+	}
+
+	// inclusive: each line of a level is in every level below
+	for(unsigned i = 0; i + 1 < levels.size(); i++){
+		for(size_t j = 0; j < lines[i].size(); j++){
+			for(unsigned k = i + 1; k < levels.size(); k++){
+				if(!levels[k].c->probe(lines[i][j])) violations++;
+			}
+		}
+	}
+	return violations;
+}
+
+unsigned long long cache_hierarchy::get_memory_reads(){
+	return memory_reads;
+}
+
+unsigned long long cache_hierarchy::get_memory_writes(){
+	return memory_writes;
+}
@@ -0,0 +1,110 @@
+#ifndef CACHE_HIERARCHY_H_
+#define CACHE_HIERARCHY_H_
+
+#include <vector>
+#include "cache.h"
+#include "cache_group.h"
+
+using namespace std;
+
+typedef enum {NON_INCLUSIVE, INCLUSIVE, EXCLUSIVE} inclusion_policy_t;
+
+// one level of the hierarchy, with the counters that the cache itself does not keep
+typedef struct{
+	cache *c;
+	unsigned long long demand_accesses;		// accesses on the path of a load/store (no write-backs)
+	unsigned long long demand_misses;
+	unsigned long long write_backs_in;		// dirty lines received from the level above
+	unsigned long long back_invalidations;	// lines removed to keep an inclusive level inclusive
+} cache_level_t;
+
+/* Chain of caches: L1 (optionally split in L1I and L1D), L2, ..., LLC, then memory
+ * the misses of a level become reads of the next level and its dirty victims (or write-through
+ * writes) become writes of the next level. The inclusion policy applies to the whole hierarchy:
+ *	- non-inclusive: a level allocates the lines it misses, evictions are independent
+ *	- inclusive: in addition, a line evicted from a level is back-invalidated in the levels above
+ *	- exclusive: the lines missed by L1 are moved up (removed from the lower levels), and the victims
+ *	  of a level are placed in the next level; the writes passed down (write-through, or not allocated)
+ *	  update the lower copy of the line, if any, or memory, without allocating the line
+ * the caches must have the same line size (and not use the OPT policy) */
+class cache_hierarchy{
+
+	inclusion_policy_t inclusion;
+	vector<cache_level_t> levels;	// levels[0] is L1 (L1D if there is an L1I)
+	cache_level_t icache;			// L1I (icache.c is NULL if L1 is unified)
+
+	unsigned long long memory_reads;
+	unsigned long long memory_writes;
+	unsigned long long number_memory_accesses;
+
+	/* trace file input (text or binary) */
+	trace_reader trace;
+
+	// the level below "level" is levels[next] (memory if next == levels.size())
+	void access_level(cache_level_t &level, unsigned next, bool is_write, address_t address, bool demand);
+	void forward(unsigned next, bool is_write, address_t address, bool demand);
+	void write_down(unsigned next, address_t address);
+	void promote(cache_level_t &level, unsigned next, address_t address);
+	void place(unsigned next, address_t address, bool is_dirty);
+	void evicted(cache_level_t &level, unsigned next, cache_victim_t &victim);
+
+	void print_level(const char *name, cache_level_t &level);
+
+public:
+
+	cache_hierarchy(inclusion_policy_t inclusion=NON_INCLUSIVE);
+
+	// de-allocates all the caches of the hierarchy
+	~cache_hierarchy();
+
+	// adds a level below the existing ones (L1 first, LLC last) and returns its index
+	// the miss penalty of the last level is the memory latency
+	unsigned add_level(const cache_config_t &config);
+
+	// splits L1: instruction fetches go to a separate L1I, which shares the levels below L1D
+	void set_instruction_cache(const cache_config_t &config);
+
+	// returns the number of levels (L1I not included)
+	unsigned size();
+
+	// returns the cache of the given level (NULL for an L1I that was not set)
+	cache *get(unsigned index);
+	cache *get_instruction_cache();
+
+	// loads the trace file (with name "filename") so that it can be used by the "run" function
+	void load_trace(const char *filename);
+
+	// processes "num_memory_accesses" memory accesses (data reads and writes) from the input trace
+	// if "num_memory_accesses=0" (default), then it processes the trace to completion
+	void run(unsigned long long num_memory_accesses=0);
+
+	// processes a data read or write
+	void access(bool is_write, address_t address);
+
+	// processes an instruction fetch (through L1I if there is one)
+	void fetch(address_t address);
+
+	// prints the configuration of each level
+	void print_configuration();
+
+	// prints the statistics of each level, the memory traffic and the end-to-end AMAT
+	void print_statistics();
+
+	// average data access time, from the hit time and demand miss rate of each level and the
+	// memory latency
+	double get_average_access_time();
+
+	// average instruction fetch time (same as the data one if L1 is unified)
+	double get_average_fetch_time();
+
+	// returns the number of lines that break the inclusion policy: for an exclusive hierarchy, the
+	// lines held by more than one level (L1I and L1D are one level); for an inclusive one, the lines
+	// missing from a level below one holding them; 0 for a non-inclusive one
+	unsigned long long check_inclusion();
+
+	// number of lines read from and written to memory
+	unsigned long long get_memory_reads();
+	unsigned long long get_memory_writes();
+};
+
+#endif /*CACHE_HIERARCHY_H_*/
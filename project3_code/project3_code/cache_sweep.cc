@@ -0,0 +1,88 @@
+#include "cache_sweep.h"
+#include "thread_pool.h"
+
+using namespace std;
+
+void cache_sweep::add(const cache_config_t &config){
+	configs.push_back(config);
+}
+
+void cache_sweep::add_grid(unsigned min_size, unsigned max_size,
+						   unsigned min_associativity, unsigned max_associativity,
+						   unsigned min_line_size, unsigned max_line_size,
+						   unsigned hit_time, unsigned miss_penalty, unsigned address_width,
+						   replacement_policy_t replacement){
+	write_policy_t hit_policy[] = {WRITE_BACK, WRITE_THROUGH};
+	write_policy_t miss_policy[] = {WRITE_ALLOCATE, NO_WRITE_ALLOCATE};
+
+	// 64-bit loop variables: doubling a value above 2^31 must not wrap around below the maximum
+	// (a minimum of 0 would not grow, so the loops start at 1 at least)
+	for(unsigned long long size = min_size ? min_size : 1; size <= max_size; size <<= 1){
+		for(unsigned long long assoc = min_associativity ? min_associativity : 1; assoc <= max_associativity; assoc <<= 1){
+			for(unsigned long long line = min_line_size ? min_line_size : 1; line <= max_line_size; line <<= 1){
+				if(assoc * line > size) continue;
+				for(unsigned h = 0; h < 2; h++){
+					for(unsigned m = 0; m < 2; m++){
+						cache_config_t config = {(unsigned) size, (unsigned) assoc, (unsigned) line, hit_policy[h], miss_policy[m],
+												 hit_time, miss_penalty, address_width, replacement};
+						add(config);
+					}
+				}
+			}
+		}
+	}
+}
+
+unsigned cache_sweep::size(){
+	return configs.size();
+}
+
+bool cache_sweep::load_trace(const char *filename){
+	return trace.load(filename);
+}
+
+void cache_sweep::run(unsigned threads){
+	results.resize(configs.size());
+
+	thread_pool pool(threads);
+	for(unsigned i = 0; i < configs.size(); i++){
+		pool.submit([this, i](){
+			const cache_config_t &c = configs[i];
+			cache sim(c.size, c.associativity, c.line_size, c.wr_hit_policy, c.wr_miss_policy,
+					  c.hit_time, c.miss_penalty, c.address_width, c.replacement);
+			sim.run(trace.data(), trace.size());
+
+			sweep_result_t &r = results[i];
+			r.config = c;
+			r.memory_accesses = sim.get_memory_accesses();
+			r.misses = sim.get_misses();
+			r.evictions = sim.get_evictions();
+			r.memory_writes = sim.num_of_mem_writes();
+			r.average_access_time = sim.get_average_access_time();
+		});
+	}
+	pool.wait();
+}
+
+const sweep_result_t &cache_sweep::get(unsigned index){
+	return results[index];
+}
+
+void cache_sweep::print_results(ostream &out){
+	out << "size,associativity,line_size,write_hit_policy,write_miss_policy,replacement_policy,"
+		<< "memory_accesses,misses,evictions,memory_writes,average_memory_access_time" << endl;
+	for(unsigned i = 0; i < results.size(); i++){
+		const sweep_result_t &r = results[i];
+		out << std::dec << r.config.size << ','
+			<< r.config.associativity << ','
+			<< r.config.line_size << ','
+			<< (r.config.wr_hit_policy == WRITE_THROUGH ? "write-through" : "write-back") << ','
+			<< (r.config.wr_miss_policy == WRITE_ALLOCATE ? "write-allocate" : "no-write-allocate") << ','
+			<< replacement_policy_name(r.config.replacement) << ','
+			<< r.memory_accesses << ','
+			<< r.misses << ','
+			<< r.evictions << ','
+			<< r.memory_writes << ','
+			<< r.average_access_time << endl;
+	}
+}
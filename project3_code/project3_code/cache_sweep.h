@@ -0,0 +1,60 @@
+#ifndef CACHE_SWEEP_H_
+#define CACHE_SWEEP_H_
+
+#include <vector>
+#include <iostream>
+#include "cache_group.h"
+
+using namespace std;
+
+// statistics of one configuration of the sweep
+typedef struct{
+	cache_config_t config;
+	unsigned long long memory_accesses;
+	unsigned long long misses;
+	unsigned long long evictions;
+	unsigned long long memory_writes;
+	double average_access_time;
+} sweep_result_t;
+
+/* Design-space sweep driver
+ * the trace is decoded once into a shared read-only buffer, then every configuration is
+ * simulated by an independent cache instance on a work-stealing thread pool */
+class cache_sweep{
+
+	vector<cache_config_t> configs;
+	vector<sweep_result_t> results;
+
+	/* decoded trace, shared by all the simulations */
+	trace_buffer trace;
+
+public:
+
+	// adds a configuration to the sweep (not with the OPT policy)
+	void add(const cache_config_t &config);
+
+	// adds every power-of-two size, associativity and line size in the given ranges,
+	// with the four write hit/miss policy combinations (geometries with no set are skipped)
+	void add_grid(unsigned min_size, unsigned max_size,
+				  unsigned min_associativity, unsigned max_associativity,
+				  unsigned min_line_size, unsigned max_line_size,
+				  unsigned hit_time, unsigned miss_penalty, unsigned address_width,
+				  replacement_policy_t replacement=LRU);
+
+	// returns the number of configurations
+	unsigned size();
+
+	// decodes the trace file (with name "filename"); returns false if it cannot be opened
+	bool load_trace(const char *filename);
+
+	// simulates all the configurations on "threads" threads (0: one per hardware thread)
+	void run(unsigned threads=0);
+
+	// returns the statistics of the configuration with the given index
+	const sweep_result_t &get(unsigned index);
+
+	// prints one CSV row per configuration
+	void print_results(ostream &out=cout);
+};
+
+#endif /*CACHE_SWEEP_H_*/
@@ -0,0 +1,108 @@
+#include "interval_sampler.h"
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+
+interval_sampler::interval_sampler(){
+	binary = false;
+	produced = 0;
+	consumed = 0;
+	stopping = false;
+}
+
+interval_sampler::~interval_sampler(){
+	close();
+}
+
+bool interval_sampler::open(const char *filename, uint64_t interval, bool binary){
+	close();
+
+	out.open(filename, ios::out | ios::binary | ios::trunc);
+	if(!out.is_open()){
+		cerr << "error: cannot create interval file " << filename << endl;
+		return false;
+	}
+	this->binary = binary;
+
+	if(binary){
+		interval_header_t header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, INTERVAL_MAGIC, sizeof(header.magic));
+		header.version = INTERVAL_VERSION;
+		header.interval = interval;
+		out.write((const char *) &header, sizeof(header));
+	}else{
+		out << "interval,first_access,accesses,reads,read_misses,writes,write_misses,evictions,"
+			<< "memory_writes,miss_rate,amat" << endl;
+	}
+
+	ring.resize(SAMPLER_RING);
+	produced = 0;
+	consumed = 0;
+	stopping = false;
+	writer = thread(&interval_sampler::write_samples, this);
+	return true;
+}
+
+void interval_sampler::advance(atomic<uint64_t> &counter, uint64_t value){
+	counter.store(value, memory_order_release);
+	// taking the lock orders the store with a waiter testing the counter before it sleeps
+	{
+		lock_guard<mutex> l(lock);
+	}
+	changed.notify_one();
+}
+
+void interval_sampler::push(const interval_sample_t &sample){
+	uint64_t slot = produced.load(memory_order_relaxed);
+	if(slot - consumed.load(memory_order_acquire) == SAMPLER_RING){
+		// back-pressure: wait for the writer to free a slot
+		unique_lock<mutex> l(lock);
+		while(slot - consumed.load(memory_order_acquire) == SAMPLER_RING) changed.wait(l);
+	}
+	ring[slot % SAMPLER_RING] = sample;
+	advance(produced, slot + 1);
+}
+
+void interval_sampler::write(const interval_sample_t &sample){
+	if(binary){
+		out.write((const char *) &sample, sizeof(sample));
+		return;
+	}
+	uint64_t misses = sample.read_misses + sample.write_misses;
+	out << sample.index << "," << sample.first_access << "," << sample.accesses << ","
+		<< sample.reads << "," << sample.read_misses << "," << sample.writes << ","
+		<< sample.write_misses << "," << sample.evictions << "," << sample.memory_writes << ","
+		<< (sample.accesses ? (double) misses / sample.accesses : 0.0) << "," << sample.amat << "\n";
+}
+
+void interval_sampler::write_samples(){
+	for(;;){
+		// read "stopping" first, so that the samples pushed before "close" are all written
+		bool last = stopping.load(memory_order_acquire);
+		uint64_t slot = consumed.load(memory_order_relaxed);
+		uint64_t end = produced.load(memory_order_acquire);
+		for(; slot < end; slot++){
+			write(ring[slot % SAMPLER_RING]);
+			advance(consumed, slot + 1);
+		}
+		if(last) break;
+
+		// wait for a sample or for "close"
+		unique_lock<mutex> l(lock);
+		while(!stopping.load(memory_order_acquire) && produced.load(memory_order_acquire) == slot) changed.wait(l);
+	}
+	out.flush();
+}
+
+void interval_sampler::close(){
+	if(!writer.joinable()) return;
+	{
+		lock_guard<mutex> l(lock);
+		stopping.store(true, memory_order_release);
+	}
+	changed.notify_all();
+	writer.join();
+	out.close();
+}
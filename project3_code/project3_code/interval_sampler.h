@@ -0,0 +1,85 @@
+#ifndef INTERVAL_SAMPLER_H_
+#define INTERVAL_SAMPLER_H_
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <stdint.h>
+
+using namespace std;
+
+#define SAMPLER_RING 1024		// samples buffered between the simulation and the writer thread
+
+/* Binary interval file
+ * header (interval_header_t) followed by one interval_sample_t per interval (little-endian) */
+#define INTERVAL_MAGIC "CISB"
+#define INTERVAL_VERSION 1
+
+typedef struct{
+	char magic[4];			// INTERVAL_MAGIC
+	uint32_t version;		// INTERVAL_VERSION
+	uint64_t interval;		// accesses per interval
+} interval_header_t;
+
+// counters of one interval (differences between the start and the end of the interval)
+typedef struct{
+	uint64_t index;				// interval number (0 for the first one)
+	uint64_t first_access;		// number of accesses before the interval
+	uint64_t accesses;			// accesses in the interval (less than the interval for the last one)
+	uint64_t reads;
+	uint64_t read_misses;
+	uint64_t writes;
+	uint64_t write_misses;
+	uint64_t evictions;
+	uint64_t memory_writes;
+	double amat;				// average memory access time over the interval
+} interval_sample_t;
+
+/* Streams interval samples to a CSV or binary file
+ * the simulation thread pushes the samples into a preallocated single-producer/single-consumer
+ * ring, and a writer thread formats and writes them; "push" only waits for the writer when the
+ * ring is full, so that no sample is lost */
+class interval_sampler{
+
+	ofstream out;
+	bool binary;
+	thread writer;
+
+	vector<interval_sample_t> ring;		// SAMPLER_RING samples
+	atomic<uint64_t> produced;
+	atomic<uint64_t> consumed;
+	atomic<bool> stopping;
+	mutex lock;							// guards the waits on "changed"
+	condition_variable changed;			// signalled when a counter moves or the writer is stopped
+
+	// main loop of the writer thread
+	void write_samples();
+
+	// stores "value" to "counter" and wakes the other thread
+	void advance(atomic<uint64_t> &counter, uint64_t value);
+
+	// writes one sample to the file
+	void write(const interval_sample_t &sample);
+
+public:
+
+	interval_sampler();
+
+	// flushes the samples and closes the file
+	~interval_sampler();
+
+	// creates the file (CSV, or binary if "binary") and starts the writer thread
+	// returns false if the file cannot be created
+	bool open(const char *filename, uint64_t interval, bool binary=false);
+
+	// queues a sample, waiting for the writer thread if the ring is full
+	void push(const interval_sample_t &sample);
+
+	// writes the queued samples, stops the writer thread and closes the file
+	void close();
+};
+
+#endif /*INTERVAL_SAMPLER_H_*/
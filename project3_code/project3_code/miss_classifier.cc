@@ -0,0 +1,95 @@
+#include "miss_classifier.h"
+#include <iostream>
+
+using namespace std;
+
+#define BLOCK_SET_INITIAL 1024	// initial number of slots (power of two)
+
+// mixes the bits of a block address (consecutive blocks must not fill consecutive slots)
+static inline uint64_t hash_block(uint64_t block){
+	block ^= block >> 33;
+	block *= 0xff51afd7ed558ccdULL;
+	block ^= block >> 33;
+	return block;
+}
+
+block_set::block_set(){
+	slots.assign(BLOCK_SET_INITIAL, 0);
+	used = 0;
+}
+
+void block_set::grow(){
+	vector<uint64_t> old;
+	old.swap(slots);
+	slots.assign(old.size() * 2, 0);
+
+	size_t mask = slots.size() - 1;
+	for(size_t i = 0; i < old.size(); i++){
+		if(old[i] == 0) continue;
+		size_t s = hash_block(old[i]) & mask;
+		while(slots[s] != 0) s = (s + 1) & mask;
+		slots[s] = old[i];
+	}
+}
+
+bool block_set::insert(uint64_t block){
+	uint64_t key = block + 1;
+	size_t mask = slots.size() - 1;
+	size_t s = hash_block(key) & mask;
+	while(slots[s] != 0){
+		if(slots[s] == key) return false;
+		s = (s + 1) & mask;
+	}
+	slots[s] = key;
+	if(++used * 2 > slots.size()) grow();
+	return true;
+}
+
+size_t block_set::size(){
+	return used;
+}
+
+miss_classifier::miss_classifier(unsigned size, unsigned line_size, write_policy_t wr_miss_policy, unsigned address_width){
+	offset_bits = 0;
+	for(unsigned temp = line_size; temp >>= 1;) offset_bits++;
+
+	// associativity 0: fully-associative, with O(1) lookups and LRU updates
+	shadow = new cache(size, 0, line_size, WRITE_BACK, wr_miss_policy, 0, 0, address_width, LRU);
+
+	compulsory_misses = 0;
+	capacity_misses = 0;
+	conflict_misses = 0;
+}
+
+miss_classifier::~miss_classifier(){
+	delete shadow;
+}
+
+void miss_classifier::classify(bool is_write, address_t address, access_type_t result){
+	access_type_t shadow_result = shadow->access(is_write, address);
+
+	// every access records the block: the first access to a block may hit (on a prefetched line)
+	bool first = seen.insert(address >> offset_bits);
+	if(result == HIT) return;
+	if(first) compulsory_misses++;
+	else if(shadow_result == MISS) capacity_misses++;
+	else conflict_misses++;
+}
+
+void miss_classifier::print_statistics(){
+	cout << "compulsory misses = " << std::dec << compulsory_misses << endl;
+	cout << "capacity misses = " << std::dec << capacity_misses << endl;
+	cout << "conflict misses = " << std::dec << conflict_misses << endl;
+}
+
+unsigned long long miss_classifier::get_compulsory_misses(){
+	return compulsory_misses;
+}
+
+unsigned long long miss_classifier::get_capacity_misses(){
+	return capacity_misses;
+}
+
+unsigned long long miss_classifier::get_conflict_misses(){
+	return conflict_misses;
+}
@@ -0,0 +1,60 @@
+#ifndef MISS_CLASSIFIER_H_
+#define MISS_CLASSIFIER_H_
+
+#include <vector>
+#include <stdint.h>
+#include "cache.h"
+
+using namespace std;
+
+/* Set of block addresses (open addressing, linear probing, grown to stay at most half full) */
+class block_set{
+
+	vector<uint64_t> slots;		// block + 1 (0: empty slot)
+	size_t used;
+
+	void grow();
+
+public:
+
+	block_set();
+
+	// adds "block"; returns false if it was already in the set
+	bool insert(uint64_t block);
+
+	// returns the number of blocks in the set
+	size_t size();
+};
+
+/* 3C classification of the misses of a cache (Hill)
+ *	- compulsory: first access to the block
+ *	- capacity: the access also misses in a fully-associative LRU cache of the same size
+ *	- conflict: the other misses
+ * every access of the cache must be passed to "classify" (hits keep the shadow cache up to date) */
+class miss_classifier{
+
+	unsigned offset_bits;
+	block_set seen;			// blocks accessed so far
+	cache *shadow;			// fully-associative LRU cache with the same size, line and write-miss policy
+
+	unsigned long long compulsory_misses;
+	unsigned long long capacity_misses;
+	unsigned long long conflict_misses;
+
+public:
+
+	miss_classifier(unsigned size, unsigned line_size, write_policy_t wr_miss_policy, unsigned address_width);
+	~miss_classifier();
+
+	// classifies an access of the cache, whose result was "result"
+	void classify(bool is_write, address_t address, access_type_t result);
+
+	// prints the number of misses of each kind
+	void print_statistics();
+
+	unsigned long long get_compulsory_misses();
+	unsigned long long get_capacity_misses();
+	unsigned long long get_conflict_misses();
+};
+
+#endif /*MISS_CLASSIFIER_H_*/
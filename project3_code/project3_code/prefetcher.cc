@@ -0,0 +1,128 @@
+#include "prefetcher.h"
+#include <string.h>
+
+using namespace std;
+
+static const char *prefetcher_names[] = {"none", "next-line", "stride", "stream"};
+
+const char *prefetcher_name(prefetcher_t type){
+	return prefetcher_names[type];
+}
+
+bool parse_prefetcher(const char *name, prefetcher_t &type){
+	for(unsigned i = 0; i < sizeof(prefetcher_names) / sizeof(prefetcher_names[0]); i++){
+		if(strcmp(name, prefetcher_names[i]) == 0){
+			type = (prefetcher_t) i;
+			return true;
+		}
+	}
+	return false;
+}
+
+prefetcher *new_prefetcher(prefetcher_t type, unsigned line_size){
+	switch(type){
+		case NEXT_LINE: return new next_line_prefetcher();
+		case STRIDE: return new stride_prefetcher(line_size);
+		case STREAM: return new stream_prefetcher();
+		default: return NULL;
+	}
+}
+
+/* next-line */
+
+void next_line_prefetcher::train(address_t block, bool miss, unsigned degree, vector<address_t> &blocks){
+	for(unsigned k = 1; k <= degree; k++) blocks.push_back(block + k);
+}
+
+const char *next_line_prefetcher::name(){
+	return prefetcher_name(NEXT_LINE);
+}
+
+/* stride */
+
+stride_prefetcher::stride_prefetcher(unsigned line_size){
+	region_shift = 0;
+	for(unsigned blocks = STRIDE_REGION / line_size; blocks >>= 1;) region_shift++;
+	table.resize(STRIDE_TABLE);
+	for(unsigned i = 0; i < STRIDE_TABLE; i++) table[i].valid = false;
+}
+
+void stride_prefetcher::train(address_t block, bool miss, unsigned degree, vector<address_t> &blocks){
+	address_t region = block >> region_shift;
+	stride_entry_t &e = table[region % STRIDE_TABLE];
+
+	if(!e.valid || e.region != region){
+		e.region = region;
+		e.last = block;
+		e.stride = 0;
+		e.confidence = 0;
+		e.valid = true;
+		return;
+	}
+
+	long long stride = (long long)(block - e.last);
+	if(stride == 0) return;
+	if(stride == e.stride){
+		if(e.confidence < 3) e.confidence++;
+	}else if(e.confidence > 0){
+		e.confidence--;
+	}else{
+		e.stride = stride;
+	}
+	e.last = block;
+
+	if(e.confidence >= 2){
+		for(unsigned k = 1; k <= degree; k++) blocks.push_back(block + e.stride * (long long) k);
+	}
+}
+
+const char *stride_prefetcher::name(){
+	return prefetcher_name(STRIDE);
+}
+
+/* stream */
+
+stream_prefetcher::stream_prefetcher(){
+	table.resize(STREAM_TABLE);
+	for(unsigned i = 0; i < STREAM_TABLE; i++) table[i].valid = false;
+	time = 0;
+}
+
+void stream_prefetcher::train(address_t block, bool miss, unsigned degree, vector<address_t> &blocks){
+	time++;
+
+	// stream whose head is close to the block (or the least recently used one)
+	unsigned lru = 0;
+	for(unsigned i = 0; i < STREAM_TABLE; i++){
+		stream_entry_t &e = table[i];
+		if(!e.valid){
+			lru = i;
+			continue;
+		}
+		long long distance = (long long)(block - e.head);
+		if(distance != 0 && distance >= -STREAM_WINDOW && distance <= STREAM_WINDOW){
+			int direction = distance > 0 ? 1 : -1;
+			if(e.direction == direction) e.confirmed = true;
+			else e.confirmed = false;
+			e.direction = direction;
+			e.head = block;
+			e.used = time;
+			if(e.confirmed){
+				for(unsigned k = 1; k <= degree; k++) blocks.push_back(block + direction * (long long) k);
+			}
+			return;
+		}
+		if(table[lru].valid && e.used < table[lru].used) lru = i;
+	}
+
+	stream_entry_t &e = table[lru];
+	e.head = block;
+	e.direction = 0;
+	e.confirmed = false;
+	e.used = time;
+	e.valid = true;
+}
+
+const char *stream_prefetcher::name(){
+	return prefetcher_name(STREAM);
+}
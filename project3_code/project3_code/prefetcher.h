@@ -0,0 +1,138 @@
+#ifndef PREFETCHER_H_
+#define PREFETCHER_H_
+
+#include <vector>
+#include <deque>
+#include <stdint.h>
+#include "trace.h"
+
+using namespace std;
+
+typedef enum {NO_PREFETCH, NEXT_LINE, STRIDE, STREAM} prefetcher_t;
+
+#define PREFETCH_MAX_DEGREE 16		// largest prefetch degree reached by throttling
+#define PREFETCH_QUEUE 32			// prefetches in flight (when they have a latency)
+#define PREFETCH_INTERVAL 4096		// prefetches issued between two throttling decisions
+#define PREFETCH_HIGH_ACCURACY 0.75	// throttling: above, the degree is increased
+#define PREFETCH_LOW_ACCURACY 0.40	// throttling: below, the degree is decreased
+#define POLLUTION_FILTER 4096		// blocks evicted by prefetches remembered to detect pollution
+
+/* Hardware prefetcher of a cache
+ * the cache trains it with the block address (address / line size) of each demand miss and of
+ * each first demand hit to a prefetched line, and it returns the blocks to prefetch */
+class prefetcher{
+
+public:
+
+	virtual ~prefetcher(){}
+
+	// trains the prefetcher with an access to "block" and appends up to "degree" blocks to prefetch
+	virtual void train(address_t block, bool miss, unsigned degree, vector<address_t> &blocks) = 0;
+
+	// returns the name of the prefetcher
+	virtual const char *name() = 0;
+};
+
+// returns the name of the prefetcher ("none", "next-line", "stride", "stream")
+const char *prefetcher_name(prefetcher_t type);
+
+// finds the prefetcher with the given name; returns false if there is none
+bool parse_prefetcher(const char *name, prefetcher_t &type);
+
+// instantiates the given prefetcher for a cache with lines of "line_size" bytes (NULL for NO_PREFETCH)
+prefetcher *new_prefetcher(prefetcher_t type, unsigned line_size);
+
+// prefetch statistics of a cache
+typedef struct{
+	unsigned long long issued;		// prefetches that filled a line
+	unsigned long long useful;		// prefetched lines hit by a demand access
+	unsigned long long useless;		// prefetched lines evicted before any demand access
+	unsigned long long late;		// demand misses to a block whose prefetch was still in flight
+	unsigned long long redundant;	// prefetches dropped since the block was cached or in flight
+	unsigned long long dropped;		// prefetches dropped since the queue was full
+	unsigned long long pollution;	// demand misses to a block evicted by a prefetch
+} prefetch_stats_t;
+
+// prefetch request in flight
+typedef struct{
+	address_t block;
+	unsigned long long ready;		// access count at which the line is filled
+} prefetch_request_t;
+
+// prefetching state of a cache (see cache::enable_prefetcher)
+typedef struct{
+	prefetcher *engine;
+	unsigned degree;				// blocks prefetched per training event
+	bool throttle;					// adjust "degree" to the measured accuracy
+	unsigned latency;				// accesses between a prefetch and its fill (0: immediate)
+	bool *prefetched;				// [line] => filled by a prefetch and not accessed since
+	deque<prefetch_request_t> queue;
+	vector<address_t> candidates;
+	vector<address_t> filter;		// pollution filter: blocks evicted by prefetches (hashed)
+	prefetch_stats_t stats;
+	unsigned long long clock;		// demand accesses seen
+	unsigned long long interval_issued;	// counters at the last throttling decision
+	unsigned long long interval_useful;
+	bool trained;					// the current access hit a prefetched line
+} prefetch_state_t;
+
+/* Next-line: prefetches the "degree" blocks following each miss */
+class next_line_prefetcher : public prefetcher{
+
+public:
+
+	void train(address_t block, bool miss, unsigned degree, vector<address_t> &blocks);
+	const char *name();
+};
+
+#define STRIDE_TABLE 256		// regions tracked by the stride prefetcher
+#define STRIDE_REGION 4096		// region size (in bytes)
+
+/* Stride: detects a constant stride between the accesses to each region (per-region table,
+ * 2-bit confidence) and prefetches "degree" strides ahead once it is confirmed */
+class stride_prefetcher : public prefetcher{
+
+	typedef struct{
+		address_t region;
+		address_t last;			// last block accessed in the region
+		long long stride;		// in blocks
+		unsigned confidence;
+		bool valid;
+	} stride_entry_t;
+
+	unsigned region_shift;		// block => region
+	vector<stride_entry_t> table;
+
+public:
+
+	stride_prefetcher(unsigned line_size);
+	void train(address_t block, bool miss, unsigned degree, vector<address_t> &blocks);
+	const char *name();
+};
+
+#define STREAM_TABLE 16			// streams tracked by the stream prefetcher
+#define STREAM_WINDOW 16		// blocks around the head of a stream that belong to it
+
+/* Stream: follows ascending or descending streams of misses; a stream is confirmed by two
+ * accesses in the same direction, then each access to it prefetches "degree" blocks ahead */
+class stream_prefetcher : public prefetcher{
+
+	typedef struct{
+		address_t head;			// last block accessed in the stream
+		int direction;			// +1, -1 (0: not known yet)
+		bool confirmed;
+		unsigned long long used;	// LRU replacement of the streams
+		bool valid;
+	} stream_entry_t;
+
+	vector<stream_entry_t> table;
+	unsigned long long time;
+
+public:
+
+	stream_prefetcher();
+	void train(address_t block, bool miss, unsigned degree, vector<address_t> &blocks);
+	const char *name();
+};
+
+#endif /*PREFETCHER_H_*/
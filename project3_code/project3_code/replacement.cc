@@ -0,0 +1,395 @@
+#include "replacement.h"
+#include <string.h>
+#include <iostream>
+
+using namespace std;
+
+static const char *policy_names[] = {"lru", "tree-plru", "bit-plru", "fifo", "random", "srrip", "brrip", "drrip", "opt"};
+
+const char *replacement_policy_name(replacement_policy_t policy){
+	return policy_names[policy];
+}
+
+bool parse_replacement_policy(const char *name, replacement_policy_t &policy){
+	for(unsigned i = 0; i < sizeof(policy_names) / sizeof(policy_names[0]); i++){
+		if(strcmp(name, policy_names[i]) == 0){
+			policy = (replacement_policy_t) i;
+			return true;
+		}
+	}
+	return false;
+}
+
+replacement_policy *new_replacement_policy(replacement_policy_t policy, unsigned sets, unsigned associativity){
+	switch(policy){
+		case PLRU_TREE: return new tree_plru_policy(sets, associativity);
+		case PLRU_BIT: return new bit_plru_policy(sets, associativity);
+		case FIFO: return new lru_policy(sets, associativity, true);
+		case RANDOM: return new random_policy(sets, associativity);
+		case SRRIP:
+		case BRRIP:
+		case DRRIP: return new rrip_policy(sets, associativity, policy);
+		case OPT: return new opt_policy(sets, associativity);
+		default: return new lru_policy(sets, associativity, false);
+	}
+}
+
+/* LRU / FIFO */
+
+lru_policy::lru_policy(unsigned sets, unsigned associativity, bool fifo){
+	this->associativity = associativity;
+	this->fifo = fifo;
+	prev.resize((size_t) sets * associativity);
+	next.resize((size_t) sets * associativity);
+	head.resize(sets);
+	tail.resize(sets);
+
+	// initial order: way 0 most recently used, last way least recently used
+	for(unsigned s = 0; s < sets; s++){
+		size_t base = (size_t) s * associativity;
+		for(unsigned w = 0; w < associativity; w++){
+			prev[base + w] = w - 1;
+			next[base + w] = w + 1;
+		}
+		head[s] = 0;
+		tail[s] = associativity - 1;
+	}
+}
+
+void lru_policy::move_to_front(unsigned set, unsigned way){
+	if(head[set] == way) return;
+	size_t base = (size_t) set * associativity;
+
+	// unlink
+	unsigned p = prev[base + way];
+	unsigned n = next[base + way];
+	next[base + p] = n;
+	if(tail[set] == way) tail[set] = p;
+	else prev[base + n] = p;
+
+	// link at the head (the head's "prev" is not used)
+	next[base + way] = head[set];
+	prev[base + head[set]] = way;
+	head[set] = way;
+}
+
+void lru_policy::touch(unsigned set, unsigned way){
+	if(!fifo) move_to_front(set, way);
+}
+
+void lru_policy::insert(unsigned set, unsigned way){
+	move_to_front(set, way);
+}
+
+unsigned lru_policy::victim(unsigned set){
+	return tail[set];
+}
+
+const char *lru_policy::name(){
+	return replacement_policy_name(fifo ? FIFO : LRU);
+}
+
+void lru_policy::save(ostream &out){
+	save_vector(out, prev);
+	save_vector(out, next);
+	save_vector(out, head);
+	save_vector(out, tail);
+}
+
+bool lru_policy::load(istream &in){
+	return load_vector(in, prev) && load_vector(in, next) && load_vector(in, head) && load_vector(in, tail);
+}
+
+/* tree pseudo-LRU */
+
+tree_plru_policy::tree_plru_policy(unsigned sets, unsigned associativity){
+	this->associativity = associativity;
+	leaves = 1;
+	levels = 0;
+	while(leaves < associativity){
+		leaves <<= 1;
+		levels++;
+	}
+	tree.assign((size_t) sets * (leaves - 1), 0);
+}
+
+void tree_plru_policy::touch(unsigned set, unsigned way){
+	unsigned char *t = tree.data() + (size_t) set * (leaves - 1);
+	unsigned node = 0;
+	for(unsigned l = 0; l < levels; l++){
+		unsigned bit = (way >> (levels - 1 - l)) & 1;
+		t[node] = !bit; // point to the other half
+		node = 2 * node + 1 + bit;
+	}
+}
+
+void tree_plru_policy::insert(unsigned set, unsigned way){
+	touch(set, way);
+}
+
+unsigned tree_plru_policy::victim(unsigned set){
+	const unsigned char *t = tree.data() + (size_t) set * (leaves - 1);
+	unsigned node = 0;
+	unsigned way = 0;
+	for(unsigned l = 0; l < levels; l++){
+		unsigned bit = t[node];
+		// with a non power-of-two associativity, never descend into a subtree without lines
+		if(bit && ((way << 1 | 1) << (levels - 1 - l)) >= associativity) bit = 0;
+		way = way << 1 | bit;
+		node = 2 * node + 1 + bit;
+	}
+	return way;
+}
+
+const char *tree_plru_policy::name(){
+	return replacement_policy_name(PLRU_TREE);
+}
+
+void tree_plru_policy::save(ostream &out){
+	save_vector(out, tree);
+}
+
+bool tree_plru_policy::load(istream &in){
+	return load_vector(in, tree);
+}
+
+/* bit pseudo-LRU */
+
+bit_plru_policy::bit_plru_policy(unsigned sets, unsigned associativity){
+	this->associativity = associativity;
+	words = (associativity + 63) / 64;
+	mru.assign((size_t) sets * words, 0);
+	count.assign(sets, 0);
+}
+
+void bit_plru_policy::touch(unsigned set, unsigned way){
+	uint64_t *m = mru.data() + (size_t) set * words;
+	uint64_t bit = (uint64_t) 1 << (way & 63);
+	if(m[way / 64] & bit) return;
+
+	if(count[set] + 1 == associativity){
+		// all the lines would be MRU: keep only this one
+		for(unsigned w = 0; w < words; w++) m[w] = 0;
+		count[set] = 0;
+	}
+	m[way / 64] |= bit;
+	count[set]++;
+}
+
+void bit_plru_policy::insert(unsigned set, unsigned way){
+	touch(set, way);
+}
+
+unsigned bit_plru_policy::victim(unsigned set){
+	const uint64_t *m = mru.data() + (size_t) set * words;
+	for(unsigned w = 0; w < words; w++){
+		if(~m[w]){
+			unsigned way = w * 64 + __builtin_ctzll(~m[w]);
+			return way < associativity ? way : 0;
+		}
+	}
+	return 0;
+}
+
+const char *bit_plru_policy::name(){
+	return replacement_policy_name(PLRU_BIT);
+}
+
+void bit_plru_policy::save(ostream &out){
+	save_vector(out, mru);
+	save_vector(out, count);
+}
+
+bool bit_plru_policy::load(istream &in){
+	return load_vector(in, mru) && load_vector(in, count);
+}
+
+/* random */
+
+random_policy::random_policy(unsigned sets, unsigned associativity){
+	this->associativity = associativity;
+	state.resize(sets);
+	for(unsigned s = 0; s < sets; s++) state[s] = (s + 1) * 2654435761u | 1;
+}
+
+void random_policy::touch(unsigned set, unsigned way){
+}
+
+void random_policy::insert(unsigned set, unsigned way){
+}
+
+unsigned random_policy::victim(unsigned set){
+	uint32_t x = state[set];
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	state[set] = x;
+	return x % associativity;
+}
+
+const char *random_policy::name(){
+	return replacement_policy_name(RANDOM);
+}
+
+void random_policy::save(ostream &out){
+	save_vector(out, state);
+}
+
+bool random_policy::load(istream &in){
+	return load_vector(in, state);
+}
+
+/* RRIP */
+
+rrip_policy::rrip_policy(unsigned sets, unsigned associativity, replacement_policy_t mode){
+	this->mode = mode;
+	this->associativity = associativity;
+	rrpv.assign((size_t) sets * associativity, RRIP_MAX);
+	fills.assign(sets, 0);
+
+	// leader sets spread evenly: one SRRIP and one BRRIP leader per constituency of "stride" sets
+	// (at least half of the sets are followers; caches with less than 4 sets have no leaders)
+	role.assign(sets, FOLLOWER);
+	if(mode == DRRIP){
+		unsigned stride = sets / DRRIP_LEADERS;
+		if(stride < 4) stride = 4;
+		for(unsigned s = 0; s + stride / 2 < sets; s += stride){
+			role[s] = SRRIP_LEADER;
+			role[s + stride / 2] = BRRIP_LEADER;
+		}
+	}
+	psel = 1 << (DRRIP_PSEL_BITS - 1);
+	leader_misses[0] = leader_misses[1] = 0;
+	follower_inserts[0] = follower_inserts[1] = 0;
+}
+
+void rrip_policy::touch(unsigned set, unsigned way){
+	rrpv[(size_t) set * associativity + way] = 0;
+}
+
+bool rrip_policy::bimodal_insert(unsigned set){
+	switch(mode){
+		case SRRIP: return false;
+		case BRRIP: return true;
+		default: break;
+	}
+
+	// DRRIP: leaders train PSEL with their misses, followers use the winning policy
+	switch(role[set]){
+		case SRRIP_LEADER:
+			leader_misses[0]++;
+			if(psel < (1u << DRRIP_PSEL_BITS) - 1) psel++;
+			return false;
+		case BRRIP_LEADER:
+			leader_misses[1]++;
+			if(psel > 0) psel--;
+			return true;
+		default:
+			bool brrip = psel >= (1u << (DRRIP_PSEL_BITS - 1));
+			follower_inserts[brrip]++;
+			return brrip;
+	}
+}
+
+void rrip_policy::insert(unsigned set, unsigned way){
+	unsigned char value = RRIP_MAX - 1;
+	if(bimodal_insert(set) && (fills[set] % BRRIP_LONG_RATE) != 0) value = RRIP_MAX;
+	fills[set]++;
+	rrpv[(size_t) set * associativity + way] = value;
+}
+
+unsigned rrip_policy::victim(unsigned set){
+	unsigned char *r = rrpv.data() + (size_t) set * associativity;
+
+	// age the set so that its oldest line reaches RRIP_MAX, and replace the first such line
+	unsigned char oldest = 0;
+	for(unsigned w = 0; w < associativity; w++){
+		if(r[w] > oldest) oldest = r[w];
+	}
+	unsigned victim = 0;
+	bool found = false;
+	for(unsigned w = 0; w < associativity; w++){
+		r[w] += RRIP_MAX - oldest;
+		if(!found && r[w] == RRIP_MAX){
+			victim = w;
+			found = true;
+		}
+	}
+	return victim;
+}
+
+const char *rrip_policy::name(){
+	return replacement_policy_name(mode);
+}
+
+void rrip_policy::save(ostream &out){
+	save_vector(out, rrpv);
+	save_vector(out, fills);
+	out.write((const char *) &psel, sizeof(psel));
+	out.write((const char *) leader_misses, sizeof(leader_misses));
+	out.write((const char *) follower_inserts, sizeof(follower_inserts));
+}
+
+bool rrip_policy::load(istream &in){
+	if(!load_vector(in, rrpv) || !load_vector(in, fills)) return false;
+	in.read((char *) &psel, sizeof(psel));
+	in.read((char *) leader_misses, sizeof(leader_misses));
+	in.read((char *) follower_inserts, sizeof(follower_inserts));
+	return (bool) in;
+}
+
+bool rrip_policy::shared_state(){
+	return mode == DRRIP;
+}
+
+void rrip_policy::print_statistics(){
+	if(mode != DRRIP) return;
+	unsigned long long inserts = follower_inserts[0] + follower_inserts[1];
+	cout << "srrip leader misses = " << std::dec << leader_misses[0] << endl;
+	cout << "brrip leader misses = " << std::dec << leader_misses[1] << endl;
+	cout << "follower srrip insertions = " << std::dec << follower_inserts[0] << endl;
+	cout << "follower brrip insertions = " << std::dec << follower_inserts[1] << endl;
+	cout << "brrip win rate = " << (inserts ? (double) follower_inserts[1] / (double) inserts : 0.0) << endl;
+	cout << "psel = " << std::dec << psel << endl;
+}
+
+/* OPT */
+
+opt_policy::opt_policy(unsigned sets, unsigned associativity){
+	this->associativity = associativity;
+	next.assign((size_t) sets * associativity, UINT64_MAX);
+	next_access = UINT64_MAX;
+}
+
+void opt_policy::set_next_use(uint64_t now, uint32_t distance){
+	next_access = distance == NEXT_USE_NONE ? UINT64_MAX : now + distance;
+}
+
+void opt_policy::touch(unsigned set, unsigned way){
+	next[(size_t) set * associativity + way] = next_access;
+}
+
+void opt_policy::insert(unsigned set, unsigned way){
+	next[(size_t) set * associativity + way] = next_access;
+}
+
+unsigned opt_policy::victim(unsigned set){
+	const uint64_t *n = next.data() + (size_t) set * associativity;
+	unsigned victim = 0;
+	for(unsigned w = 1; w < associativity; w++){
+		if(n[w] > n[victim]) victim = w;
+	}
+	return victim;
+}
+
+const char *opt_policy::name(){
+	return replacement_policy_name(OPT);
+}
+
+void opt_policy::save(ostream &out){
+	save_vector(out, next);
+}
+
+bool opt_policy::load(istream &in){
+	return load_vector(in, next);
+}
@@ -0,0 +1,219 @@
+#ifndef REPLACEMENT_H_
+#define REPLACEMENT_H_
+
+#include <vector>
+#include <iostream>
+#include <stdint.h>
+#include "trace.h"
+
+using namespace std;
+
+typedef enum {LRU, PLRU_TREE, PLRU_BIT, FIFO, RANDOM, SRRIP, BRRIP, DRRIP, OPT} replacement_policy_t;
+
+/* Replacement policy of a cache
+ * unless "shared_state" says otherwise, the state of each set is independent of the other sets
+ * (so that the sets can be simulated in parallel) */
+class replacement_policy{
+
+public:
+
+	virtual ~replacement_policy(){}
+
+	// the block in line "way" of "set" was accessed (cache hit)
+	virtual void touch(unsigned set, unsigned way) = 0;
+
+	// a new block was placed in line "way" of "set" (cache miss)
+	virtual void insert(unsigned set, unsigned way) = 0;
+
+	// returns the line of the (full) set whose block is to be replaced
+	virtual unsigned victim(unsigned set) = 0;
+
+	// returns the name of the policy
+	virtual const char *name() = 0;
+
+	// returns true if the sets share state (they can't be simulated in parallel)
+	virtual bool shared_state(){ return false; }
+
+	// prints the statistics specific to the policy, if any
+	virtual void print_statistics(){}
+
+	// checkpoints: writes the state of the policy, and reads it back into a policy of the same
+	// geometry (returns false if the data does not match; the state is then partly overwritten, so
+	// the state is loaded into a new policy, replacing the current one only on success)
+	virtual void save(ostream &out) = 0;
+	virtual bool load(istream &in) = 0;
+};
+
+// checkpoint helpers: a vector is stored as its number of elements followed by the elements
+template<class T> void save_vector(ostream &out, const vector<T> &v){
+	uint64_t size = v.size();
+	out.write((const char *) &size, sizeof(size));
+	out.write((const char *) v.data(), sizeof(T) * v.size());
+}
+
+// reads a vector saved by save_vector; returns false if its size is not that of "v"
+template<class T> bool load_vector(istream &in, vector<T> &v){
+	uint64_t size = 0;
+	in.read((char *) &size, sizeof(size));
+	if(!in || size != v.size()) return false;
+	in.read((char *) v.data(), sizeof(T) * v.size());
+	return (bool) in;
+}
+
+// returns the name of the policy ("lru", "tree-plru", "bit-plru", "fifo", "random", "srrip", "brrip", "drrip", "opt")
+const char *replacement_policy_name(replacement_policy_t policy);
+
+// finds the policy with the given name; returns false if there is none
+bool parse_replacement_policy(const char *name, replacement_policy_t &policy);
+
+// instantiates the given policy for a cache with "sets" sets of "associativity" lines
+replacement_policy *new_replacement_policy(replacement_policy_t policy, unsigned sets, unsigned associativity);
+
+/* LRU (or FIFO): the lines of each set are kept in a doubly-linked list ordered by recency of
+ * use (or of insertion), so that updates and victim selection are O(1) */
+class lru_policy : public replacement_policy{
+
+	unsigned associativity;
+	bool fifo;					// hits do not change the order
+	vector<unsigned> prev;		// [set * associativity + way] => more recently used line
+	vector<unsigned> next;		// [set * associativity + way] => less recently used line
+	vector<unsigned> head;		// [set] => most recently used line
+	vector<unsigned> tail;		// [set] => least recently used line
+
+	// moves the line to the head of its set's list
+	void move_to_front(unsigned set, unsigned way);
+
+public:
+
+	lru_policy(unsigned sets, unsigned associativity, bool fifo);
+	void touch(unsigned set, unsigned way);
+	void insert(unsigned set, unsigned way);
+	unsigned victim(unsigned set);
+	const char *name();
+	void save(ostream &out);
+	bool load(istream &in);
+};
+
+/* Tree pseudo-LRU: a binary tree of associativity-1 bits per set, each bit pointing to the
+ * less recently used half of its subtree; O(log associativity) per access */
+class tree_plru_policy : public replacement_policy{
+
+	unsigned associativity;
+	unsigned leaves;			// associativity rounded up to a power of two
+	unsigned levels;			// log2(leaves)
+	vector<unsigned char> tree;	// [set * (leaves-1) + node], node 0 is the root
+
+public:
+
+	tree_plru_policy(unsigned sets, unsigned associativity);
+	void touch(unsigned set, unsigned way);
+	void insert(unsigned set, unsigned way);
+	unsigned victim(unsigned set);
+	const char *name();
+	void save(ostream &out);
+	bool load(istream &in);
+};
+
+/* Bit pseudo-LRU (MRU bits): one bit per line set on access; when all the bits of a set would
+ * be set, the others are cleared. The victim is the first line whose bit is clear */
+class bit_plru_policy : public replacement_policy{
+
+	unsigned associativity;
+	unsigned words;				// 64-bit words per set
+	vector<uint64_t> mru;		// [set * words + way / 64] => MRU bits
+	vector<unsigned> count;		// [set] => number of MRU bits set
+
+public:
+
+	bit_plru_policy(unsigned sets, unsigned associativity);
+	void touch(unsigned set, unsigned way);
+	void insert(unsigned set, unsigned way);
+	unsigned victim(unsigned set);
+	const char *name();
+	void save(ostream &out);
+	bool load(istream &in);
+};
+
+/* Random: a xorshift generator per set, seeded from the set index (reproducible runs) */
+class random_policy : public replacement_policy{
+
+	unsigned associativity;
+	vector<uint32_t> state;		// [set] => generator state
+
+public:
+
+	random_policy(unsigned sets, unsigned associativity);
+	void touch(unsigned set, unsigned way);
+	void insert(unsigned set, unsigned way);
+	unsigned victim(unsigned set);
+	const char *name();
+	void save(ostream &out);
+	bool load(istream &in);
+};
+
+#define RRIP_BITS 2					// bits of re-reference prediction value (RRPV) per line
+#define RRIP_MAX ((1 << RRIP_BITS) - 1)	// RRPV of a line predicted to be re-referenced in the distant future
+#define BRRIP_LONG_RATE 32			// BRRIP inserts 1 in BRRIP_LONG_RATE blocks with a long (not distant) RRPV
+#define DRRIP_LEADERS 32			// leader sets per insertion policy
+#define DRRIP_PSEL_BITS 10			// width of the policy selection counter
+
+/* Re-reference interval prediction (Jaleel et al., ISCA 2010)
+ * SRRIP inserts blocks with a long RRPV (RRIP_MAX-1), BRRIP mostly with a distant RRPV (RRIP_MAX),
+ * which protects the cache from scans. DRRIP duels the two insertion policies: a few leader sets
+ * always use one of them, the misses of the leaders move the PSEL counter, and the other sets
+ * (followers) insert with the policy whose leaders miss less. Hits promote lines to RRPV 0 */
+class rrip_policy : public replacement_policy{
+
+	typedef enum {FOLLOWER, SRRIP_LEADER, BRRIP_LEADER} set_role_t;
+
+	replacement_policy_t mode;	// SRRIP, BRRIP or DRRIP
+	unsigned associativity;
+	vector<unsigned char> rrpv;	// [set * associativity + way] => re-reference prediction value
+	vector<unsigned> fills;		// [set] => blocks inserted (BRRIP throttle)
+
+	/* set dueling (DRRIP) */
+	vector<unsigned char> role;	// [set] => set_role_t
+	unsigned psel;				// > half: SRRIP leaders miss more, followers use BRRIP
+	unsigned long long leader_misses[2];		// misses of the SRRIP and BRRIP leader sets
+	unsigned long long follower_inserts[2];		// follower insertions with SRRIP and BRRIP
+
+	// returns true if the block inserted in "set" gets the BRRIP insertion
+	bool bimodal_insert(unsigned set);
+
+public:
+
+	rrip_policy(unsigned sets, unsigned associativity, replacement_policy_t mode);
+	void touch(unsigned set, unsigned way);
+	void insert(unsigned set, unsigned way);
+	unsigned victim(unsigned set);
+	const char *name();
+	void save(ostream &out);
+	bool load(istream &in);
+	bool shared_state();
+	void print_statistics();
+};
+
+/* Belady's optimal replacement (MIN): evicts the line whose next use is furthest in the future
+ * the policy cannot see the trace: before each access, the cache passes the next-use distance of the
+ * accessed block (see trace_buffer::index_next_use) with "set_next_use" */
+class opt_policy : public replacement_policy{
+
+	unsigned associativity;
+	vector<uint64_t> next;		// [set * associativity + way] => index of the next access to the line
+	uint64_t next_access;		// index of the next access to the block being accessed
+
+public:
+
+	opt_policy(unsigned sets, unsigned associativity);
+	void touch(unsigned set, unsigned way);
+	void insert(unsigned set, unsigned way);
+	unsigned victim(unsigned set);
+	const char *name();
+	void save(ostream &out);
+	bool load(istream &in);
+
+	// sets the next use of the block accessed at index "now" of the trace (NEXT_USE_NONE: never)
+	void set_next_use(uint64_t now, uint32_t distance);
+};
+
+#endif /*REPLACEMENT_H_*/
@@ -0,0 +1,206 @@
+#include "shards.h"
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+
+using namespace std;
+
+shards::shards(cache *c, double rate, unsigned max_blocks) : shards(1u << c->get_offset_bits(), rate, max_blocks){
+}
+
+shards::shards(unsigned line_size, double rate, unsigned max_blocks){
+	this->line_size = line_size;
+	this->max_blocks = max_blocks;
+
+	offset_bits = 0;
+	unsigned temp = line_size;
+	while (temp >>= 1) ++offset_bits;
+
+	if(rate <= 0 || rate > 1) rate = 1;
+	threshold = (uint32_t) (rate * SHARDS_MODULUS);
+	if(threshold == 0) threshold = 1;
+	initial_threshold = threshold;
+
+	hist.assign((size_t) SHARDS_GROUPS * SHARDS_BUCKETS, 0);
+	group_references.assign(SHARDS_GROUPS, 0);
+	sampled_references = 0;
+	sampled_blocks = 0;
+	number_memory_accesses = 0;
+	time = 0;
+}
+
+void shards::load_trace(const char *filename){
+	trace.open(filename);
+}
+
+void shards::run(unsigned long long num_entries){
+	unsigned long long first_access = number_memory_accesses;
+	trace_record_t rec;
+
+	while (trace.next(rec)){
+		access(rec.address);
+		if (num_entries!=0 && (number_memory_accesses-first_access)==num_entries)
+			break;
+	}
+}
+
+inline uint32_t shards::hash(address_t block){
+	block ^= block >> 33;
+	block *= 0xff51afd7ed558ccdULL;
+	block ^= block >> 33;
+	block *= 0xc4ceb9fe1a85ec53ULL;
+	block ^= block >> 33;
+	return block & (SHARDS_MODULUS - 1);
+}
+
+double shards::get_rate(){
+	return (double) threshold / SHARDS_MODULUS;
+}
+
+unsigned shards::bucket(unsigned long long distance){
+	if(distance < (1ULL << SHARDS_SUB_BITS)) return distance;
+	// distance in [2^e, 2^(e+1)): the SHARDS_SUB_BITS bits after the leading one select the bucket
+	unsigned e = 63 - __builtin_clzll(distance);
+	unsigned sub = (distance >> (e - SHARDS_SUB_BITS)) & ((1u << SHARDS_SUB_BITS) - 1);
+	return ((e - SHARDS_SUB_BITS + 1) << SHARDS_SUB_BITS) + sub;
+}
+
+unsigned long long shards::bucket_start(unsigned b){
+	if(b < (1u << SHARDS_SUB_BITS)) return b;
+	unsigned e = (b >> SHARDS_SUB_BITS) + SHARDS_SUB_BITS - 1;
+	unsigned long long sub = b & ((1u << SHARDS_SUB_BITS) - 1);
+	return (1ULL << e) | (sub << (e - SHARDS_SUB_BITS));
+}
+
+void shards::access(address_t address){
+	address_t block = address >> offset_bits;
+	number_memory_accesses++;
+
+	uint32_t h = hash(block);
+	if(h >= threshold) return;
+
+	unsigned group = (h >> 1) % SHARDS_GROUPS;	// not the lowest bit: the threshold also tests it
+	unsigned long long now = time++;
+	sampled_references++;
+	group_references[group]++;
+	pair<unordered_map<address_t, unsigned long long>::iterator, bool> last = last_access.insert(make_pair(block, now));
+	if(last.second){
+		// first reference (a miss of every cache: it is not in the histogram)
+		sampled_blocks++;
+		stack.insert(now);
+		if(max_blocks != 0){
+			by_hash.insert(make_pair(h, block));
+			if(last_access.size() > max_blocks) lower_threshold();
+		}
+		return;
+	}
+
+	// sampled blocks accessed after the previous reference, scaled to all the blocks
+	unsigned long long prev = last.first->second;
+	unsigned long long distance = stack.size() - stack.order_of_key(prev) - 1;
+	stack.erase(prev);
+	stack.insert(now);
+	last.first->second = now;
+	hist[(size_t) group * SHARDS_BUCKETS + bucket((unsigned long long) (distance / get_rate()))]++;
+}
+
+void shards::lower_threshold(){
+	double old_rate = get_rate();
+	while(last_access.size() > max_blocks){
+		// drop the blocks with the largest hash, which is the new threshold
+		uint32_t h = by_hash.rbegin()->first;
+		while(!by_hash.empty() && by_hash.rbegin()->first == h){
+			address_t block = by_hash.rbegin()->second;
+			unordered_map<address_t, unsigned long long>::iterator it = last_access.find(block);
+			stack.erase(it->second);
+			last_access.erase(it);
+			by_hash.erase(--by_hash.end());
+		}
+		threshold = h;
+	}
+
+	// counts of the histogram at the new rate
+	double scale = get_rate() / old_rate;
+	for(size_t b = 0; b < hist.size(); b++) hist[b] *= scale;
+	for(unsigned g = 0; g < SHARDS_GROUPS; g++) group_references[g] *= scale;
+	sampled_references *= scale;
+}
+
+double shards::hits_below(const double *h, unsigned long long lines){
+	double hits = 0;
+	for(unsigned b = 0; b < SHARDS_BUCKETS; b++){
+		unsigned long long low = bucket_start(b);
+		if(low >= lines) break;
+		unsigned long long high = b + 1 < SHARDS_BUCKETS ? bucket_start(b + 1) : UINT64_MAX;
+		if(high <= lines) hits += h[b];
+		else hits += h[b] * (double) (lines - low) / (double) (high - low); // partial bucket
+	}
+	return hits;
+}
+
+double shards::get_miss_ratio(unsigned long long size, double &confidence){
+	confidence = 0;
+	double rate = get_rate();
+
+	// SHARDS-adj: the references missing from (or exceeding) the expected number of sampled
+	// references are counted as hits of the smallest cache (fixed rate only)
+	double total = sampled_references;
+	double adjust = 0;
+	if(max_blocks == 0){
+		double distance0 = 0;
+		for(unsigned g = 0; g < SHARDS_GROUPS; g++) distance0 += hist[(size_t) g * SHARDS_BUCKETS];
+		adjust = number_memory_accesses * rate - sampled_references;
+		if(distance0 + adjust < 0) adjust = -distance0;
+		total += adjust;
+	}
+	if(total <= 0 || sampled_references <= 0) return 0;
+
+	// a reference hits if its distance is below the number of lines of the cache
+	unsigned long long lines = size / line_size;
+	double group_misses[SHARDS_GROUPS];
+	double hits = adjust, misses = 0;
+	for(unsigned g = 0; g < SHARDS_GROUPS; g++){
+		double group_hits = hits_below(&hist[(size_t) g * SHARDS_BUCKETS], lines);
+		group_misses[g] = group_references[g] - group_hits;
+		hits += group_hits;
+		misses += group_misses[g];
+	}
+
+	double miss_ratio = 1 - hits / total;
+	if(miss_ratio < 0) miss_ratio = 0;
+
+	// reference-weighted variance, from the spread of the groups: with SHARDS-adj the estimate is
+	// misses / expected references (a sum of the misses of the groups), otherwise it is the ratio
+	// misses / sampled references
+	double spread = 0;
+	for(unsigned g = 0; g < SHARDS_GROUPS; g++){
+		double deviation = max_blocks == 0 ? group_misses[g] - misses / SHARDS_GROUPS
+										   : group_misses[g] - misses / sampled_references * group_references[g];
+		spread += deviation * deviation;
+	}
+	double references = max_blocks == 0 ? total : sampled_references;
+	double variance = spread * SHARDS_GROUPS / (SHARDS_GROUPS - 1) / (references * references);
+	confidence = SHARDS_T95 * sqrt(variance);
+	return miss_ratio;
+}
+
+void shards::print_statistics(unsigned long long max_size){
+	cout << "SHARDS MISS RATIO CURVE" << endl;
+	cout << "cache line size = " << std::dec << line_size << " B" << endl;
+	cout << "memory accesses = " << std::dec << number_memory_accesses << endl;
+	cout << "sampling rate = " << get_rate();
+	if(max_blocks != 0) cout << " (fixed size: " << std::dec << max_blocks << " blocks, initial rate "
+							 << (double) initial_threshold / SHARDS_MODULUS << ")";
+	cout << endl;
+	cout << "sampled references = " << std::dec << time << endl;
+	cout << "sampled blocks = " << std::dec << sampled_blocks << endl;
+	cout << setfill(' ') << setw(10) << "size" << setw(12) << "miss ratio" << setw(12) << "+-95%" << endl;
+	for(unsigned long long size = 1024; size <= max_size; size <<= 1){
+		double confidence;
+		double miss_ratio = get_miss_ratio(size, confidence);
+		cout << setw(8) << std::dec << (size >> 10) << "KB" << setw(12) << std::fixed << setprecision(4) << miss_ratio
+			 << setw(12) << confidence << endl;
+	}
+	cout.unsetf(ios::fixed);
+	cout << setprecision(6);
+}
@@ -0,0 +1,108 @@
+#ifndef SHARDS_H_
+#define SHARDS_H_
+
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <stdint.h>
+#include "stack_distance.h"
+
+using namespace std;
+
+#define SHARDS_MODULUS (1u << 24)	// hashes of the blocks are in [0, SHARDS_MODULUS)
+#define SHARDS_SUB_BITS 4			// log2 of the histogram buckets per power of two (relative width 1/16)
+#define SHARDS_BUCKETS ((64 - SHARDS_SUB_BITS + 1) << SHARDS_SUB_BITS)	// buckets of the histogram
+#define SHARDS_GROUPS 32			// groups of sampled blocks (by hash) for the variance of the estimates
+#define SHARDS_T95 2.04				// 97.5% quantile of Student's t with SHARDS_GROUPS - 1 degrees of freedom
+
+/* Sampled miss ratio curve (SHARDS, Waldspurger et al., FAST 2015)
+ *
+ * Estimates the misses of fully-associative LRU caches of every size in a single pass.
+ * A block is sampled iff the hash of its address (address >> offset_bits) is below a threshold T,
+ * so that a fraction R = T / SHARDS_MODULUS of the blocks is tracked, with all their references.
+ * The reuse distance of a sampled reference among the sampled blocks, divided by R, estimates its
+ * distance in the whole trace.
+ *
+ * With a fixed rate, the memory used grows with the number of distinct blocks times R, and the
+ * histogram is adjusted for the difference between the expected and the actual number of sampled
+ * references (SHARDS-adj). With a fixed size ("max_blocks" != 0), at most "max_blocks" blocks are
+ * tracked: when a new block exceeds the limit, T is lowered to the largest hash tracked and the
+ * blocks with that hash are dropped (the histogram is rescaled to the new rate), so the memory is
+ * constant. The distances are kept in a log-linear histogram (exact below 2^SHARDS_SUB_BITS, then
+ * 2^SHARDS_SUB_BITS buckets per power of two), whose size does not depend on the trace.
+ *
+ * The confidence reported is the half-width of an approximate 95% interval of the miss ratio. The
+ * blocks are the sampling unit, and a few hot blocks can carry most of the references, so the
+ * variance is weighted by the references of the blocks: the sampled blocks are split in
+ * SHARDS_GROUPS random groups (by hash), each with its own histogram, and the variance of the
+ * estimate is computed from the spread of the misses of the groups (random groups method). It
+ * covers the sampling error only, not the rounding of the scaled distances of small caches, and
+ * it is still optimistic when a few blocks that were not sampled carry many misses (Zipf-like
+ * traces: about 80% of the errors fall within the interval). */
+class shards{
+
+	unsigned offset_bits;
+	unsigned line_size;				// cache block size (in bytes)
+	uint32_t threshold;				// blocks with a hash below it are sampled
+	uint32_t initial_threshold;
+	unsigned max_blocks;			// 0: fixed rate
+
+	// time of the last access to each tracked block, their order, and their hashes (fixed size)
+	unordered_map<address_t, unsigned long long> last_access;
+	sd_tree_t stack;
+	set< pair<uint32_t, address_t> > by_hash;
+
+	// histograms of the (scaled) reuse distances (see bucket), one per group of blocks
+	vector<double> hist;			// SHARDS_GROUPS * SHARDS_BUCKETS
+	vector<double> group_references;	// sampled references of each group (rescaled with the rate)
+	double sampled_references;		// sampled references (rescaled with the rate)
+	unsigned long long sampled_blocks;	// distinct blocks sampled (also the dropped ones)
+
+	/* number of memory accesses processed */
+	unsigned long long number_memory_accesses;
+	unsigned long long time;		// sampled references processed
+
+	/* trace file input (text or binary) */
+	trace_reader trace;
+
+	inline uint32_t hash(address_t block);
+
+	// lowers the threshold until at most "max_blocks" blocks are tracked
+	void lower_threshold();
+
+	// returns the histogram bucket of a distance, and the first distance of a bucket
+	static unsigned bucket(unsigned long long distance);
+	static unsigned long long bucket_start(unsigned b);
+
+	// returns the references of a histogram with a distance below "lines"
+	static double hits_below(const double *h, unsigned long long lines);
+
+public:
+
+	// blocks of the cache "c" (its line size), sampled at "rate"
+	// "max_blocks" != 0: fixed-size sampling, starting at "rate"
+	shards(cache *c, double rate=0.01, unsigned max_blocks=0);
+	shards(unsigned line_size, double rate=0.01, unsigned max_blocks=0);
+
+	// loads the trace file (with name "filename") so that it can be used by the "run" function
+	void load_trace(const char *filename);
+
+	// processes "num_memory_accesses" memory accesses from the input trace
+	// if "num_memory_accesses=0" (default), then it processes the trace to completion
+	void run(unsigned long long num_memory_accesses=0);
+
+	// processes one memory access
+	void access(address_t address);
+
+	// returns the current sampling rate
+	double get_rate();
+
+	// returns the estimated miss ratio of a fully-associative LRU cache of "size" bytes,
+	// and in "confidence" the half-width of its approximate 95% confidence interval
+	double get_miss_ratio(unsigned long long size, double &confidence);
+
+	// prints the miss ratio curve at every power-of-two size from 1 KB to "max_size" bytes
+	void print_statistics(unsigned long long max_size);
+};
+
+#endif /*SHARDS_H_*/
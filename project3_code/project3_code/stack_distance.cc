@@ -0,0 +1,126 @@
+#include "stack_distance.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+stack_distance::stack_distance(unsigned line_size, unsigned max_sets, unsigned max_associativity){
+	this->line_size = line_size;
+	this->max_sets = max_sets;
+	this->max_associativity = max_associativity;
+
+	offset_bits = 0;
+	unsigned temp = line_size;
+	while (temp >>= 1) ++offset_bits;
+
+	levels = 1;
+	temp = max_sets;
+	while (temp >>= 1) ++levels;
+
+	stacks.resize(levels);
+	for(unsigned l = 0; l < levels; l++) stacks[l].resize(1u << l);
+	read_hist.assign(levels * (max_associativity + 1), 0);
+	write_hist.assign(levels * (max_associativity + 1), 0);
+
+	number_memory_accesses = 0;
+	number_reads = 0;
+	number_writes = 0;
+}
+
+void stack_distance::load_trace(const char *filename){
+	trace.open(filename);
+}
+
+void stack_distance::run(unsigned long long num_entries){
+	unsigned long long first_access = number_memory_accesses;
+	trace_record_t rec;
+
+	while (trace.next(rec)){
+		access(rec.write, rec.address);
+		if (num_entries!=0 && (number_memory_accesses-first_access)==num_entries)
+			break;
+	}
+}
+
+void stack_distance::access(bool is_write, address_t address){
+	address_t block = address >> offset_bits;
+	unsigned long long now = number_memory_accesses;
+
+	pair<unordered_map<address_t, unsigned long long>::iterator, bool> last = last_access.insert(make_pair(block, now));
+	bool seen = !last.second;
+	unsigned long long prev = last.first->second;
+	last.first->second = now;
+
+	vector<unsigned long long> &hist = is_write ? write_hist : read_hist;
+
+	for(unsigned l = 0; l < levels; l++){
+		sd_tree_t &stack = stacks[l][block & ((1ULL << l) - 1)];
+		unsigned long long distance = max_associativity;
+
+		if(seen && stack.find(prev) != stack.end()){
+			// blocks of the same set accessed after "prev"
+			distance = stack.size() - stack.order_of_key(prev) - 1;
+			stack.erase(prev);
+		}
+		stack.insert(now);
+
+		// drop the least recently used block once the stack is deeper than any simulated associativity
+		if(stack.size() > max_associativity) stack.erase(stack.begin());
+
+		hist[l * (max_associativity + 1) + distance]++;
+	}
+
+	if(is_write) number_writes++;
+	else number_reads++;
+	number_memory_accesses++;
+}
+
+unsigned stack_distance::level(unsigned sets){
+	unsigned l = 0;
+	while (sets >>= 1) ++l;
+	return l;
+}
+
+unsigned long long stack_distance::get_read_misses(unsigned sets, unsigned associativity){
+	unsigned long long hits = 0;
+	unsigned l = level(sets);
+	if(l >= levels || associativity > max_associativity) return UNDEFINED;
+	for(unsigned d = 0; d < associativity; d++) hits += read_hist[l * (max_associativity + 1) + d];
+	return number_reads - hits;
+}
+
+unsigned long long stack_distance::get_write_misses(unsigned sets, unsigned associativity){
+	unsigned long long hits = 0;
+	unsigned l = level(sets);
+	if(l >= levels || associativity > max_associativity) return UNDEFINED;
+	for(unsigned d = 0; d < associativity; d++) hits += write_hist[l * (max_associativity + 1) + d];
+	return number_writes - hits;
+}
+
+unsigned long long stack_distance::get_misses(unsigned sets, unsigned associativity){
+	unsigned long long read_misses = get_read_misses(sets, associativity);
+	unsigned long long write_misses = get_write_misses(sets, associativity);
+	if(read_misses == UNDEFINED || write_misses == UNDEFINED) return UNDEFINED;
+	return read_misses + write_misses;
+}
+
+void stack_distance::print_statistics(){
+	cout << "STACK DISTANCE STATISTICS" << endl;
+	cout << "cache line size = " << std::dec << line_size << " B" << endl;
+	cout << "memory accesses = " << std::dec << number_memory_accesses << endl;
+	cout << "read = " << std::dec << number_reads << endl;
+	cout << "write = " << std::dec << number_writes << endl;
+	cout << setfill(' ') << setw(10) << "size" << setw(8) << "assoc" << setw(8) << "sets"
+		 << setw(14) << "read misses" << setw(14) << "write misses" << setw(11) << "miss rate" << endl;
+	for(unsigned sets = 1; sets <= max_sets; sets <<= 1){
+		for(unsigned assoc = 1; assoc <= max_associativity; assoc <<= 1){
+			unsigned long long size = (unsigned long long) sets * assoc * line_size;
+			unsigned long long misses = get_misses(sets, assoc);
+			cout << setw(8) << std::dec << (size >> 10) << "KB" << setw(8) << assoc << setw(8) << sets
+				 << setw(14) << get_read_misses(sets, assoc) << setw(14) << get_write_misses(sets, assoc)
+				 << setw(11) << std::fixed << setprecision(4) << (double) misses / (double) number_memory_accesses << endl;
+		}
+	}
+	cout.unsetf(ios::fixed);
+	cout << setprecision(6);
+}
@@ -0,0 +1,87 @@
+#ifndef STACK_DISTANCE_H_
+#define STACK_DISTANCE_H_
+
+#include <vector>
+#include <unordered_map>
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+#include "cache.h"
+
+using namespace std;
+
+// balanced tree of access times with order statistics (rank of a key in O(log n))
+typedef __gnu_pbds::tree<unsigned long long, __gnu_pbds::null_type, less<unsigned long long>,
+		__gnu_pbds::rb_tree_tag, __gnu_pbds::tree_order_statistics_node_update> sd_tree_t;
+
+/* LRU stack distance (Mattson) engine
+ *
+ * Computes, in a single pass over the trace, the number of misses of every LRU cache with the
+ * given line size, a power-of-two number of sets up to "max_sets" and any associativity up to
+ * "max_associativity". For each number of sets, the stack distance of an access is the number
+ * of distinct blocks of the same set referenced since the previous access to the block; the
+ * access hits in an n-way cache iff its distance is smaller than n.
+ *
+ * Each set keeps the last access times of its "max_associativity" most recently used blocks in
+ * an order-statistic tree, so an access costs O(log max_associativity) per number of sets;
+ * older blocks are dropped since their distance is too large to hit in any simulated geometry.
+ *
+ * The engine models write-allocate caches (every access brings its block in the cache), so the
+ * counts match those of the cache class with WRITE_ALLOCATE and either write hit policy. */
+class stack_distance{
+
+	unsigned line_size;				// cache block size (in bytes)
+	unsigned offset_bits;
+	unsigned max_sets;				// largest number of sets (power of two)
+	unsigned max_associativity;		// largest associativity
+	unsigned levels;				// number of set counts (1, 2, 4, ..., max_sets)
+
+	// time of the last access to each block
+	unordered_map<address_t, unsigned long long> last_access;
+
+	// LRU stack of each set, for each set count: [level][set], level l has 2^l sets
+	vector< vector<sd_tree_t> > stacks;
+
+	// stack distance histograms: [level][distance], distance "max_associativity" counts
+	// both first accesses and distances beyond the largest associativity
+	vector<unsigned long long> read_hist;
+	vector<unsigned long long> write_hist;
+
+	/* number of memory accesses processed */
+	unsigned long long number_memory_accesses;
+	unsigned long long number_reads;
+	unsigned long long number_writes;
+
+	/* trace file input (text or binary) */
+	trace_reader trace;
+
+	// returns the index of the histogram of the given number of sets
+	unsigned level(unsigned sets);
+
+public:
+
+	stack_distance(
+		unsigned line_size,				// cache block size (in bytes)
+		unsigned max_sets,				// largest number of sets (power of two)
+		unsigned max_associativity		// largest associativity
+	);
+
+	// loads the trace file (with name "filename") so that it can be used by the "run" function
+	void load_trace(const char *filename);
+
+	// processes "num_memory_accesses" memory accesses from the input trace
+	// if "num_memory_accesses=0" (default), then it processes the trace to completion
+	void run(unsigned long long num_memory_accesses=0);
+
+	// processes one memory access
+	void access(bool is_write, address_t address);
+
+	// returns the number of read/write/total misses of the LRU cache with the given geometry
+	unsigned long long get_read_misses(unsigned sets, unsigned associativity);
+	unsigned long long get_write_misses(unsigned sets, unsigned associativity);
+	unsigned long long get_misses(unsigned sets, unsigned associativity);
+
+	// prints the misses of every power-of-two cache size and associativity
+	void print_statistics();
+};
+
+#endif /*STACK_DISTANCE_H_*/
@@ -0,0 +1,55 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* time-sliced simulation: a synthetic zipf stream simulated in 4 slices on 4 threads, without and
+ * with warm-up, compared with a serial run (the difference is the slicing error) */
+
+#define ACCESSES 400000
+
+int main(int argc, char **argv){
+
+	unsigned long long warmup[] = {0, 20000};
+
+	workload_generator stream(ZIPF, 1024*KB, 0.3, 11);
+	trace_record_t *records = new trace_record_t[ACCESSES];
+	stream.read(records, ACCESSES);
+
+	cache *serial = new cache(32*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+	serial->run(records, ACCESSES);
+
+	cout << "SERIAL" << endl;
+	cout << "======" << endl << endl;
+
+	serial->print_statistics();
+
+	cout << endl;
+
+	for (unsigned i=0; i<2; i++){
+
+		cache *sliced = new cache(32*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+		sliced->run_sliced(records, ACCESSES, 4, warmup[i], 4);
+
+		cout << "4 SLICES, WARM-UP = " << dec << warmup[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		sliced->print_statistics();
+		long long difference = (long long) sliced->get_misses() - (long long) serial->get_misses();
+		cout << "misses - serial misses = " << dec << difference << endl;
+
+		cout << endl;
+
+		delete sliced;
+	}
+
+	delete serial;
+	delete [] records;
+}
@@ -0,0 +1,73 @@
+#include "shards.h"
+#include "stack_distance.h"
+#include "workload.h"
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h>
+#include <math.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* SHARDS miss ratio curve (fixed rate and fixed size) against the exact LRU miss ratios of the
+ * stack distance simulator, on synthetic uniform and zipf streams */
+
+#define ACCESSES 300000
+#define MAX_SIZE (256*KB)
+
+int main(int argc, char **argv){
+
+	const char *title[] = {"UNIFORM", "ZIPF"};
+	workload_t type[] = {UNIFORM, ZIPF};
+
+	for (unsigned i=0; i<2; i++){
+
+		workload_generator stream(type[i], 1024*KB, 0, 13);
+		stack_distance *exact = new stack_distance(64, 1, MAX_SIZE / 64);
+		shards *fixed_rate = new shards(64, 0.1);
+		shards *fixed_size = new shards(64, 0.1, 1000);
+
+		trace_record_t records[1000];
+		for (unsigned n=0; n<ACCESSES; n+=1000){
+			stream.read(records, 1000);
+			for (unsigned k=0; k<1000; k++){
+				exact->access(records[k].write, records[k].address);
+				fixed_rate->access(records[k].address);
+				fixed_size->access(records[k].address);
+			}
+		}
+
+		cout << title[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		cout << "fixed size sampling rate = " << fixed_size->get_rate() << endl;
+		cout << setw(10) << "size" << setw(10) << "exact" << setw(10) << "rate" << setw(10) << "+-"
+			 << setw(10) << "size" << setw(10) << "+-" << endl;
+		unsigned within = 0, estimates = 0;
+		for (unsigned long long size = 4*KB; size <= MAX_SIZE; size <<= 1){
+			double miss_ratio = (double) exact->get_misses(1, size / 64) / ACCESSES;
+			double rate_confidence, size_confidence;
+			double rate_ratio = fixed_rate->get_miss_ratio(size, rate_confidence);
+			double size_ratio = fixed_size->get_miss_ratio(size, size_confidence);
+			within += fabs(rate_ratio - miss_ratio) <= rate_confidence;
+			within += fabs(size_ratio - miss_ratio) <= size_confidence;
+			estimates += 2;
+			cout << setw(8) << dec << (size >> 10) << "KB" << fixed << setprecision(4) << setw(10) << miss_ratio
+				 << setw(10) << rate_ratio << setw(10) << rate_confidence
+				 << setw(10) << size_ratio << setw(10) << size_confidence << endl;
+		}
+		cout.unsetf(ios::fixed);
+		cout << setprecision(6);
+		cout << "estimates within the confidence interval = " << dec << within << "/" << estimates << endl;
+
+		cout << endl;
+
+		delete exact;
+		delete fixed_rate;
+		delete fixed_size;
+	}
+}
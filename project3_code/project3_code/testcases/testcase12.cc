@@ -0,0 +1,56 @@
+#include "cache.h"
+#include "workload.h"
+#include "miss_classifier.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* compulsory/capacity/conflict classification of the misses of a direct-mapped and a 4-way cache,
+ * on synthetic strided, zipf and pointer-chase streams with 20% writes */
+
+#define ACCESSES 100000
+
+int main(int argc, char **argv){
+
+	const char *title[] = {"STRIDED", "ZIPF", "POINTER-CHASE"};
+	workload_t type[] = {STRIDED, ZIPF, POINTER_CHASE};
+	unsigned associativity[] = {1, 4};
+
+	for (unsigned i=0; i<3; i++){
+		for (unsigned j=0; j<2; j++){
+
+		cache *mycache = new cache(8*KB,		//size
+					  associativity[j],	//associativity
+					  64,			//cache line size
+					  WRITE_BACK,		//write hit policy
+					  WRITE_ALLOCATE, 	//write miss policy
+					  5, 			//hit time
+					  100, 			//miss penalty
+					  48    		//address width
+					  );
+		mycache->enable_miss_classification();
+
+		workload_generator stream(type[i], 16*KB, 0.2, 17, 8, 4*KB + 64);
+		stream.run(mycache, ACCESSES);
+
+		cout << title[i] << ", " << dec << associativity[j] << "-WAY" << endl;
+		cout << "==========================================" << endl << endl;
+
+		mycache->print_statistics();
+		miss_classifier *classifier = mycache->get_miss_classifier();
+		unsigned long long classified = classifier->get_compulsory_misses() + classifier->get_capacity_misses() +
+										classifier->get_conflict_misses();
+		cout << "all misses classified = " << (classified == mycache->get_misses() ? "yes" : "no") << endl;
+
+		cout << endl;
+
+		delete mycache;
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* OPT replacement through run_sliced: the loaded trace is simulated serially, so the statistics
+ * must match those of "run" (the trace is a synthetic zipf stream written to a file) */
+
+#define ACCESSES 100000
+#define TRACE "testcase13.t"
+
+int main(int argc, char **argv){
+
+	workload_generator stream(ZIPF, 256*KB, 0.3, 19);
+	stream.write_trace(TRACE, ACCESSES);
+
+	cache *serial = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48, OPT);
+	serial->load_trace(TRACE);
+	serial->run();
+
+	cache *sliced = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48, OPT);
+	sliced->load_trace(TRACE);
+	sliced->run_sliced(4, 1000, 4);
+
+	cout << "OPT, 4 SLICES" << endl;
+	cout << "=============" << endl << endl;
+
+	sliced->print_statistics();
+	cout << "same statistics as the serial run = "
+		 << (sliced->get_memory_accesses() == serial->get_memory_accesses() && sliced->get_misses() == serial->get_misses() &&
+			 sliced->num_of_mem_writes() == serial->num_of_mem_writes() ? "yes" : "no") << endl;
+
+	delete serial;
+	delete sliced;
+	remove(TRACE);
+}
@@ -0,0 +1,59 @@
+#include "cache_hierarchy.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* exclusive hierarchy with a write-through and with a write-back L1 (no-write-allocate) over a
+ * write-back L2: a line dirtied in L2 and then read is moved up to L1; a write-through L1 cannot
+ * hold it dirty, so its data must reach memory */
+
+int main(int argc, char **argv){
+
+	const char *title[] = {"WRITE-THROUGH L1", "WRITE-BACK L1"};
+	write_policy_t hit_policy[] = {WRITE_THROUGH, WRITE_BACK};
+
+	// A and B share the only L1 set
+	address_t a = 0x1000, b = 0x1040;
+	bool is_write[] = {false, false, true, false, false, false};
+	address_t address[] = {a, b, a, a, b, a};
+	const char *step[] = {"read A", "read B (A moves to L2)", "write A (L2 hit: A dirty in L2)",
+						  "read A (dirty A moves to L1)", "read B (A moves to L2)", "read A"};
+
+	for (unsigned i=0; i<2; i++){
+
+		cache_config_t l1 = {64,			//size
+				     1,			//associativity
+				     64,			//cache line size
+				     hit_policy[i],		//write hit policy
+				     NO_WRITE_ALLOCATE, 	//write miss policy
+				     2, 			//hit time
+				     10, 			//miss penalty
+				     48    		//address width
+				     };
+		cache_config_t l2 = {1*KB, 2, 64, WRITE_BACK, WRITE_ALLOCATE, 10, 100, 48};
+
+		cache_hierarchy *hierarchy = new cache_hierarchy(EXCLUSIVE);
+		hierarchy->add_level(l1);
+		hierarchy->add_level(l2);
+
+		cout << title[i] << endl;
+		cout << "================" << endl << endl;
+
+		for (unsigned k=0; k<6; k++){
+			hierarchy->access(is_write[k], address[k]);
+			cout << step[k] << ": memory reads = " << dec << hierarchy->get_memory_reads()
+				 << ", memory writes = " << hierarchy->get_memory_writes()
+				 << ", inclusion violations = " << hierarchy->check_inclusion() << endl;
+		}
+
+		cout << endl;
+
+		delete hierarchy;
+	}
+}
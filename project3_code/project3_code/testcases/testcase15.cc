@@ -0,0 +1,68 @@
+#include "cache.h"
+#include "workload.h"
+#include "miss_classifier.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* miss classification with a next-line prefetcher: a block first accessed as a hit on a
+ * prefetched line is not a compulsory miss when it misses later; then the classification of a
+ * strided stream with and without the prefetcher */
+
+#define ACCESSES 100000
+
+int main(int argc, char **argv){
+
+	cache *mycache = new cache(1*KB, 1, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+	mycache->enable_miss_classification();
+	mycache->enable_prefetcher(NEXT_LINE);
+
+	// block 1 is prefetched by the miss of block 0, evicted by block 17 (same set), then missed
+	address_t address[] = {0, 64, 17*64, 64};
+	const char *step[] = {"read block 0 (prefetches block 1)", "read block 1 (prefetched)",
+						  "read block 17 (evicts block 1)", "read block 1"};
+
+	cout << "NEXT-LINE PREFETCHER, DIRECT-MAPPED" << endl;
+	cout << "===================================" << endl << endl;
+
+	miss_classifier *classifier = mycache->get_miss_classifier();
+	for (unsigned k=0; k<4; k++){
+		access_type_t result = mycache->access(false, address[k]);
+		cout << step[k] << ": " << (result == HIT ? "hit" : "miss") << ", compulsory = " << dec
+			 << classifier->get_compulsory_misses() << ", capacity = " << classifier->get_capacity_misses()
+			 << ", conflict = " << classifier->get_conflict_misses() << endl;
+	}
+	cout << endl;
+	delete mycache;
+
+	for (unsigned p=0; p<2; p++){
+
+		mycache = new cache(8*KB, 2, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+		mycache->enable_miss_classification();
+		if (p) mycache->enable_prefetcher(NEXT_LINE);
+
+		workload_generator stream(STRIDED, 64*KB, 0.2, 23, 8, 64);
+		stream.run(mycache, ACCESSES);
+
+		cout << "STRIDED, " << (p ? "NEXT-LINE PREFETCHER" : "NO PREFETCHER") << endl;
+		cout << "==========================================" << endl << endl;
+
+		mycache->print_statistics();
+		classifier = mycache->get_miss_classifier();
+		unsigned long long classified = classifier->get_compulsory_misses() + classifier->get_capacity_misses() +
+										classifier->get_conflict_misses();
+		cout << "all misses classified = " << (classified == mycache->get_misses() ? "yes" : "no") << endl;
+		cout << "compulsory misses <= blocks of the footprint = "
+			 << (classifier->get_compulsory_misses() <= 64*KB / 64 ? "yes" : "no") << endl;
+
+		cout << endl;
+
+		delete mycache;
+	}
+}
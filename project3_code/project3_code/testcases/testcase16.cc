@@ -0,0 +1,110 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* checkpoints of a cache simulating a loaded trace: the restoring cache has already run past the
+ * checkpoint (with the plain and with the background reader), and must still resume right after
+ * it; then corrupted checkpoints (a dirty bit that is not 0/1, a free way beyond the
+ * associativity) must be rejected and leave the cache unchanged */
+
+#define ACCESSES 100000
+#define TRACE "testcase16.t"
+#define CHECKPOINT "testcase16.ckpt"
+#define CORRUPT "testcase16.bad"
+
+// copies CHECKPOINT to CORRUPT with the byte at "offset" set to "value"
+static void corrupt(size_t offset, char value){
+	ifstream in(CHECKPOINT, ios::in | ios::binary);
+	stringstream data;
+	data << in.rdbuf();
+	string bytes = data.str();
+	bytes[offset] = value;
+	ofstream out(CORRUPT, ios::out | ios::binary | ios::trunc);
+	out.write(bytes.data(), bytes.size());
+}
+
+int main(int argc, char **argv){
+
+	workload_generator stream(ZIPF, 256*KB, 0.3, 29);
+	stream.write_trace(TRACE, ACCESSES);
+
+	cache *serial = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+	serial->load_trace(TRACE);
+	serial->run();
+
+	cache *first = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+	first->load_trace(TRACE);
+	first->run(ACCESSES/2);
+	first->save_checkpoint(CHECKPOINT);
+
+	for (unsigned prefetch=0; prefetch<2; prefetch++){
+
+		cache *second = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+		second->load_trace(TRACE, prefetch == 1);
+		second->run(ACCESSES*3/4);
+		bool loaded = second->load_checkpoint(CHECKPOINT);
+		second->run();
+
+		cout << "RESUME AFTER RUNNING PAST THE CHECKPOINT, " << (prefetch ? "BACKGROUND READER" : "PLAIN READER") << endl;
+		cout << "==========================================" << endl << endl;
+
+		cout << "checkpoint loaded = " << (loaded ? "yes" : "no") << endl;
+		cout << "same statistics as the serial run = "
+			 << (second->get_memory_accesses() == serial->get_memory_accesses() && second->get_misses() == serial->get_misses() &&
+				 second->num_of_mem_writes() == serial->num_of_mem_writes() ? "yes" : "no") << endl;
+
+		cout << endl;
+
+		delete second;
+	}
+
+	// fully-associative cache with free ways, so that the checkpoint holds a free way list
+	unsigned lines = 16*KB / 64;
+	cache *partial = new cache(16*KB, 0, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+	workload_generator few(SEQUENTIAL, 4*KB, 0.5, 31);
+	few.run(partial, 1000);
+	partial->save_checkpoint(CHECKPOINT);
+
+	size_t dirty_offset = sizeof(checkpoint_header_t) + sizeof(cache_stats_t) + sizeof(unsigned long long) * lines;
+	size_t free_way_offset = dirty_offset + sizeof(bool) * lines + sizeof(uint64_t);
+	size_t offset[] = {dirty_offset, free_way_offset + 3};
+	char value[] = {2, 0x7f};
+	const char *title[] = {"DIRTY BIT 2", "FREE WAY BEYOND THE ASSOCIATIVITY"};
+
+	for (unsigned i=0; i<2; i++){
+
+		corrupt(offset[i], value[i]);
+		cache *restored = new cache(16*KB, 0, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+		workload_generator other(UNIFORM, 64*KB, 0.5, 37);
+		other.run(restored, 500);
+		unsigned long long misses = restored->get_misses();
+
+		cout << "CORRUPTED CHECKPOINT: " << title[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		bool loaded = restored->load_checkpoint(CORRUPT);
+		cout << "checkpoint loaded = " << (loaded ? "yes" : "no") << endl;
+		cout << "cache unchanged = " << (restored->get_misses() == misses && restored->get_memory_accesses() == 500 ? "yes" : "no") << endl;
+
+		cout << endl;
+
+		delete restored;
+	}
+
+	delete partial;
+	delete serial;
+	delete first;
+	remove(TRACE);
+	remove(CHECKPOINT);
+	remove(CORRUPT);
+}
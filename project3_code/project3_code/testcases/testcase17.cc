@@ -0,0 +1,58 @@
+#include "trace.h"
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sstream>
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* text trace parser: optional 0x prefix, upper and lower case digits, blank lines and lines
+ * without an address, and addresses of up to 16 digits (a 17-digit address does not fit in 64
+ * bits, so its line is rejected); the lines are long enough for both the scalar and the vector
+ * paths of the parser */
+
+#define TRACE "testcase17.t"
+
+int main(int argc, char **argv){
+
+	const char *lines[] = {
+		"r 1000",
+		"w 0x2000",
+		"",
+		"r",
+		"w deadBEEF",
+		"r ffffffffffffffff",
+		"w 0x123456789abcdef0",
+		"r 1ffffffffffffffff",
+		"w 0x10000000000000000",
+		"r 0000000000000000042",
+		"   w\t7f",
+		"r 40 trailing text",
+		"r zz",
+		"w 0xffffffffffffffff"
+	};
+	unsigned count = sizeof(lines) / sizeof(lines[0]);
+
+	ofstream out(TRACE, ios::out | ios::trunc);
+	for (unsigned i=0; i<count; i++) out << lines[i] << endl;
+	out.close();
+
+	cout << "TEXT TRACE PARSER" << endl;
+	cout << "=================" << endl << endl;
+
+	trace_reader reader;
+	reader.open(TRACE);
+	trace_record_t rec;
+	unsigned records = 0;
+	while (reader.next(rec)){
+		cout << (rec.write ? "w " : "r ") << hex << rec.address << endl;
+		records++;
+	}
+	cout << "records = " << dec << records << endl;
+
+	reader.close();
+	remove(TRACE);
+}
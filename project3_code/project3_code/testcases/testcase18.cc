@@ -0,0 +1,90 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* binary traces: a synthetic text trace converted to the raw and the delta binary formats must
+ * decode to the same records and give the same statistics; a raw trace whose header claims more
+ * records than the file holds (even so many that their size overflows) must be rejected */
+
+#define ACCESSES 50000
+#define TEXT "testcase18.t"
+#define RAW "testcase18.raw"
+#define DELTA "testcase18.delta"
+#define BAD "testcase18.bad"
+
+int main(int argc, char **argv){
+
+	workload_generator stream(POINTER_CHASE, 1024*KB, 0.3, 41);
+	stream.write_trace(TEXT, ACCESSES);
+
+	const char *title[] = {"TEXT", "RAW BINARY", "DELTA BINARY"};
+	const char *file[] = {TEXT, RAW, DELTA};
+	cout << "converted records (raw) = " << dec << convert_trace(TEXT, RAW, false) << endl;
+	cout << "converted records (delta) = " << dec << convert_trace(TEXT, DELTA, true) << endl << endl;
+
+	trace_buffer text;
+	text.load(TEXT);
+
+	for (unsigned i=0; i<3; i++){
+
+		trace_reader reader;
+		bool opened = reader.open(file[i]);
+		bool binary = reader.is_binary();
+		trace_record_t rec;
+		size_t records = 0, different = 0;
+		while (reader.next(rec)){
+			if (records >= text.size() || rec.address != text.data()[records].address ||
+				rec.write != text.data()[records].write) different++;
+			records++;
+		}
+		reader.close();
+
+		cache *mycache = new cache(32*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+		mycache->load_trace(file[i]);
+		mycache->run();
+
+		cout << title[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		cout << "opened = " << (opened ? "yes" : "no") << ", binary = " << (binary ? "yes" : "no") << endl;
+		cout << "records = " << dec << records << ", different from the text trace = " << different << endl;
+		mycache->print_statistics();
+
+		cout << endl;
+
+		delete mycache;
+	}
+
+	// header of the raw trace with a larger count: by one record, and by so many records that
+	// their size (8 bytes each, plus an 8-byte op mask per 64 records) wraps around to 504 bytes
+	uint64_t count[] = {ACCESSES + 1, 2270368501379637184ULL};
+	for (unsigned i=0; i<2; i++){
+		ifstream in(RAW, ios::in | ios::binary);
+		trace_header_t header;
+		in.read((char *) &header, sizeof(header));
+		header.count = count[i];
+		ofstream out(BAD, ios::out | ios::binary | ios::trunc);
+		out.write((const char *) &header, sizeof(header));
+		out << in.rdbuf();
+		out.close();
+
+		trace_reader reader;
+		bool opened = reader.open(BAD);
+		cout << "raw trace with a count of " << dec << count[i] << " opened = " << (opened ? "yes" : "no") << endl;
+	}
+
+	remove(TEXT);
+	remove(RAW);
+	remove(DELTA);
+	remove(BAD);
+}
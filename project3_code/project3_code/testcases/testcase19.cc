@@ -0,0 +1,73 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+#include <set>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* synthetic workload generator: for each pattern, the first accesses, the share of writes, the
+ * accesses outside the footprint (always 0), the distinct lines touched, that "reset" replays the
+ * same stream, and the statistics of a cache; an OPT cache is refused */
+
+#define ACCESSES 20000
+
+int main(int argc, char **argv){
+
+	workload_t type[] = {SEQUENTIAL, STRIDED, UNIFORM, ZIPF, POINTER_CHASE};
+	trace_record_t *records = new trace_record_t[ACCESSES];
+	trace_record_t *again = new trace_record_t[ACCESSES];
+
+	for (unsigned i=0; i<5; i++){
+
+		workload_generator stream(type[i], 64*KB, 0.25, 43, 8, 256);
+		stream.read(records, ACCESSES);
+		stream.reset();
+		stream.read(again, ACCESSES);
+
+		unsigned writes = 0, outside = 0, replayed = 0;
+		set<address_t> lines;
+		for (unsigned k=0; k<ACCESSES; k++){
+			writes += records[k].write;
+			outside += records[k].address < 0x10000000 || records[k].address >= 0x10000000 + 64*KB;
+			replayed += records[k].address == again[k].address && records[k].write == again[k].write;
+			lines.insert(records[k].address >> 6);
+		}
+
+		cout << workload_name(type[i]) << endl;
+		cout << "==========================================" << endl << endl;
+
+		cout << "first accesses =";
+		for (unsigned k=0; k<6; k++) cout << " " << (records[k].write ? "w " : "r ") << hex << records[k].address;
+		cout << endl;
+		cout << "writes = " << dec << writes << ", accesses outside the footprint = " << outside << endl;
+		cout << "distinct lines = " << dec << lines.size() << endl;
+		cout << "same stream after reset = " << (replayed == ACCESSES ? "yes" : "no") << endl;
+
+		cache *mycache = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48);
+		stream.reset();
+		stream.run(mycache, ACCESSES);
+		mycache->print_statistics();
+
+		cout << endl;
+
+		delete mycache;
+	}
+
+	cout << "OPT CACHE" << endl;
+	cout << "==========================================" << endl << endl;
+
+	cache *opt = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48, OPT);
+	workload_generator stream(ZIPF, 64*KB);
+	stream.run(opt, ACCESSES);
+	cout << "memory accesses simulated = " << dec << opt->get_memory_accesses() << endl;
+
+	delete opt;
+	delete [] records;
+	delete [] again;
+}
@@ -0,0 +1,64 @@
+#include "cache.h"
+#include "stack_distance.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* LRU stack distance engine: the misses it computes in one pass for each number of sets and
+ * associativity must match those of LRU caches simulated one at a time (write-back and
+ * write-through, write-allocate), on synthetic strided, zipf and uniform streams with 30% writes */
+
+#define ACCESSES 50000
+#define MAX_SETS 64
+#define MAX_ASSOC 16
+
+int main(int argc, char **argv){
+
+	workload_t type[] = {STRIDED, ZIPF, UNIFORM};
+	trace_record_t *records = new trace_record_t[ACCESSES];
+
+	for (unsigned i=0; i<3; i++){
+
+		workload_generator stream(type[i], 48*KB, 0.3, 29, 8, 192);
+		stream.read(records, ACCESSES);
+
+		stack_distance *engine = new stack_distance(64, MAX_SETS, MAX_ASSOC);
+		for (unsigned k=0; k<ACCESSES; k++)
+			engine->access(records[k].write, records[k].address);
+
+		cout << workload_name(type[i]) << endl;
+		cout << "==========================================" << endl << endl;
+
+		engine->print_statistics();
+
+		unsigned matching = 0, geometries = 0;
+		for (unsigned sets = 1; sets <= MAX_SETS; sets <<= 2){
+			for (unsigned assoc = 1; assoc <= MAX_ASSOC; assoc <<= 1){
+				write_policy_t hit_policy = (assoc & 2) ? WRITE_THROUGH : WRITE_BACK;
+				cache *mycache = new cache(sets*assoc*64, assoc, 64, hit_policy, WRITE_ALLOCATE, 5, 100, 48);
+				mycache->run(records, ACCESSES);
+				bool same = mycache->get_misses() == engine->get_misses(sets, assoc);
+				matching += same;
+				geometries++;
+				if (!same) cout << "mismatch: sets = " << dec << sets << ", assoc = " << assoc
+								<< ", cache = " << mycache->get_misses()
+								<< ", stack distance = " << engine->get_misses(sets, assoc) << endl;
+				delete mycache;
+			}
+		}
+		cout << "geometries matching the LRU caches = " << dec << matching << "/" << geometries << endl;
+
+		cout << endl;
+
+		delete engine;
+	}
+
+	delete [] records;
+}
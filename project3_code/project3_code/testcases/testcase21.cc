@@ -0,0 +1,74 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* pluggable replacement policies (LRU, tree PLRU, bit PLRU, FIFO, random): the lines left in a
+ * 4-way set by a directed sequence, then the statistics of a 16KB 8-way cache on a synthetic
+ * zipf stream with 25% writes, simulated serially and by run_parallel (identical counts) */
+
+#define ACCESSES 100000
+#define TRACE "testcase21.trace"
+
+int main(int argc, char **argv){
+
+	replacement_policy_t policy[] = {LRU, PLRU_TREE, PLRU_BIT, FIFO, RANDOM};
+	// blocks of the directed sequence: they all map to the single set of a 256B 4-way cache
+	unsigned sequence[] = {0, 1, 2, 3, 0, 4, 1, 5, 2, 6, 0, 7};
+
+	workload_generator stream(ZIPF, 256*KB, 0.25, 5);
+	stream.write_trace(TRACE, ACCESSES);
+
+	for (unsigned i=0; i<5; i++){
+
+		replacement_policy_t parsed;
+		bool found = parse_replacement_policy(replacement_policy_name(policy[i]), parsed);
+
+		cout << replacement_policy_name(policy[i]) << endl;
+		cout << "==========================================" << endl << endl;
+
+		cout << "name parsed back = " << (found && parsed == policy[i] ? "yes" : "no") << endl;
+
+		cache *set = new cache(256, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 1, 10, 32, policy[i]);
+		cout << "directed sequence =";
+		for (unsigned k=0; k<sizeof(sequence)/sizeof(unsigned); k++){
+			access_type_t result = set->access(false, sequence[k] * 64);
+			cout << " " << sequence[k] << (result == HIT ? "h" : "m");
+		}
+		cout << endl;
+		cout << "lines left =";
+		for (unsigned block=0; block<8; block++)
+			if (set->probe(block * 64)) cout << " " << block;
+		cout << endl << endl;
+
+		cache *serial = new cache(16*KB, 8, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32, policy[i]);
+		serial->load_trace(TRACE);
+		serial->run();
+		serial->print_statistics();
+
+		cache *parallel = new cache(16*KB, 8, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32, policy[i]);
+		parallel->load_trace(TRACE);
+		parallel->run_parallel(4);
+		bool same = parallel->get_memory_accesses() == serial->get_memory_accesses()
+				 && parallel->get_misses() == serial->get_misses()
+				 && parallel->get_evictions() == serial->get_evictions()
+				 && parallel->num_of_mem_writes() == serial->num_of_mem_writes();
+		cout << "run_parallel statistics identical = " << (same ? "yes" : "no") << endl;
+
+		cout << endl;
+
+		delete set;
+		delete serial;
+		delete parallel;
+	}
+
+	remove(TRACE);
+}
@@ -0,0 +1,69 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* RRIP replacement: LRU, SRRIP, BRRIP and DRRIP on a 32KB 4-way cache (512 lines), with a hot
+ * set of 256 lines re-read between scans of 512 new lines (SRRIP resists the scans), a loop over
+ * 768 lines (BRRIP keeps part of it, LRU misses every access) and a synthetic zipf stream;
+ * DRRIP approaches the better of SRRIP and BRRIP (its set dueling statistics are printed) */
+
+#define ACCESSES 200000
+#define BASE 0x10000000
+
+int main(int argc, char **argv){
+
+	const char *title[] = {"HOT SET AND SCANS", "LOOP", "ZIPF"};
+	replacement_policy_t policy[] = {LRU, SRRIP, BRRIP, DRRIP};
+	trace_record_t *records = new trace_record_t[ACCESSES];
+
+	for (unsigned i=0; i<3; i++){
+
+		if (i == 0){
+			// two passes over the hot set, then a scan of lines never accessed again
+			unsigned k = 0, scan = 0;
+			while (k < ACCESSES){
+				for (unsigned pass=0; pass<2; pass++)
+					for (unsigned line=0; line<256 && k<ACCESSES; line++, k++){
+						records[k].write = false;
+						records[k].address = BASE + line * 64;
+					}
+				for (unsigned line=0; line<512 && k<ACCESSES; line++, k++, scan++){
+					records[k].write = false;
+					records[k].address = BASE + (256 + scan) * 64;
+				}
+			}
+		} else if (i == 1){
+			for (unsigned k=0; k<ACCESSES; k++){
+				records[k].write = k % 5 == 0;
+				records[k].address = BASE + (k % 768) * 64;
+			}
+		} else {
+			workload_generator stream(ZIPF, 128*KB, 0.25, 17);
+			stream.read(records, ACCESSES);
+		}
+
+		cout << title[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		for (unsigned p=0; p<4; p++){
+			cache *mycache = new cache(32*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32, policy[p]);
+			mycache->run(records, ACCESSES);
+			cout << replacement_policy_name(policy[p]) << ": misses = " << dec << mycache->get_misses()
+				 << ", memory writes = " << mycache->num_of_mem_writes() << endl;
+			if (policy[p] == DRRIP) mycache->print_statistics();
+			delete mycache;
+		}
+
+		cout << endl;
+	}
+
+	delete [] records;
+}
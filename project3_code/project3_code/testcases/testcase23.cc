@@ -0,0 +1,92 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* Belady OPT replacement: a directed sequence on a single 4-way set (8 misses with OPT, 12 with
+ * LRU), then OPT against every other policy on traces of synthetic zipf, uniform and
+ * pointer-chase streams with 25% writes (OPT never misses more); the OPT trace is also simulated
+ * in chunks of "run" (same statistics as a single run) */
+
+#define ACCESSES 100000
+#define TRACE "testcase23.trace"
+
+int main(int argc, char **argv){
+
+	replacement_policy_t policy[] = {LRU, PLRU_TREE, PLRU_BIT, FIFO, RANDOM, SRRIP, BRRIP, DRRIP};
+	unsigned sequence[] = {0, 1, 2, 3, 4, 0, 1, 2, 5, 0, 1, 2, 3, 4, 5};
+	unsigned length = sizeof(sequence)/sizeof(unsigned);
+
+	cout << "DIRECTED SEQUENCE" << endl;
+	cout << "==========================================" << endl << endl;
+
+	ofstream out(TRACE);
+	for (unsigned k=0; k<length; k++) out << "r 0x" << hex << sequence[k] * 64 << endl;
+	out.close();
+
+	cache *opt = new cache(256, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 1, 10, 32, OPT);
+	cache *lru = new cache(256, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 1, 10, 32, LRU);
+	opt->load_trace(TRACE);
+	opt->run();
+	lru->load_trace(TRACE);
+	lru->run();
+	cout << "opt misses = " << dec << opt->get_misses() << endl;
+	cout << "lru misses = " << dec << lru->get_misses() << endl;
+	cout << "lines left with opt =";
+	for (unsigned block=0; block<6; block++)
+		if (opt->probe(block * 64)) cout << " " << block;
+	cout << endl << endl;
+	delete opt;
+	delete lru;
+
+	const char *title[] = {"ZIPF", "UNIFORM", "POINTER CHASE"};
+	workload_t type[] = {ZIPF, UNIFORM, POINTER_CHASE};
+
+	for (unsigned i=0; i<3; i++){
+
+		workload_generator stream(type[i], 64*KB, 0.25, 23);
+		stream.write_trace(TRACE, ACCESSES);
+
+		cout << title[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		opt = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32, OPT);
+		opt->load_trace(TRACE);
+		opt->run();
+		opt->print_statistics();
+
+		unsigned worse = 0;
+		for (unsigned p=0; p<8; p++){
+			cache *other = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32, policy[p]);
+			other->load_trace(TRACE);
+			other->run();
+			cout << replacement_policy_name(policy[p]) << " misses = " << dec << other->get_misses() << endl;
+			worse += other->get_misses() < opt->get_misses();
+			delete other;
+		}
+		cout << "policies missing less than opt = " << dec << worse << endl;
+
+		cache *chunks = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32, OPT);
+		chunks->load_trace(TRACE);
+		while (chunks->get_memory_accesses() < ACCESSES) chunks->run(7777);
+		bool same = chunks->get_misses() == opt->get_misses() && chunks->get_evictions() == opt->get_evictions()
+				 && chunks->num_of_mem_writes() == opt->num_of_mem_writes();
+		cout << "statistics of the run in chunks identical = " << (same ? "yes" : "no") << endl;
+
+		cout << endl;
+
+		delete opt;
+		delete chunks;
+	}
+
+	remove(TRACE);
+}
@@ -0,0 +1,96 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* batched accesses: access_batch, and read_batch/write_batch on the reads and the writes of the
+ * stream, against one "access" call per memory access (same hit/miss of each access, same
+ * statistics), for a 4-way write-back/write-allocate cache, a direct-mapped write-through/
+ * no-write-allocate cache, and a fully-associative cache, on a synthetic zipf stream with 30%
+ * writes whose length is not a multiple of CACHE_BATCH */
+
+#define ACCESSES 100003
+
+// returns true if the statistics of the two caches are the same
+bool same_statistics(cache *a, cache *b){
+	return a->get_memory_accesses() == b->get_memory_accesses() && a->get_misses() == b->get_misses()
+		&& a->get_evictions() == b->get_evictions() && a->num_of_mem_writes() == b->num_of_mem_writes();
+}
+
+int main(int argc, char **argv){
+
+	const char *title[] = {"16KB 4-WAY WB/WA", "8KB DIRECT-MAPPED WT/NWA", "8KB FULLY-ASSOCIATIVE WB/WA"};
+	unsigned size[] = {16*KB, 8*KB, 8*KB};
+	unsigned assoc[] = {4, 1, 0};
+	write_policy_t hit_policy[] = {WRITE_BACK, WRITE_THROUGH, WRITE_BACK};
+	write_policy_t miss_policy[] = {WRITE_ALLOCATE, NO_WRITE_ALLOCATE, WRITE_ALLOCATE};
+
+	workload_generator stream(ZIPF, 128*KB, 0.3, 31);
+	trace_record_t *records = new trace_record_t[ACCESSES];
+	stream.read(records, ACCESSES);
+
+	// the reads and the writes of the stream, in order
+	address_t *reads = new address_t[ACCESSES];
+	address_t *writes = new address_t[ACCESSES];
+	unsigned read_count = 0, write_count = 0;
+	for (unsigned k=0; k<ACCESSES; k++){
+		if (records[k].write) writes[write_count++] = records[k].address;
+		else reads[read_count++] = records[k].address;
+	}
+
+	access_type_t *expected = new access_type_t[ACCESSES];
+	access_type_t *results = new access_type_t[ACCESSES];
+
+	for (unsigned i=0; i<3; i++){
+
+		cout << title[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		// the whole stream, one access at a time and in one batch
+		cache *single = new cache(size[i], assoc[i], 64, hit_policy[i], miss_policy[i], 5, 100, 32);
+		cache *batch = new cache(size[i], assoc[i], 64, hit_policy[i], miss_policy[i], 5, 100, 32);
+		for (unsigned k=0; k<ACCESSES; k++) expected[k] = single->access(records[k].write, records[k].address);
+		batch->access_batch(records, ACCESSES, results);
+		unsigned differences = 0;
+		for (unsigned k=0; k<ACCESSES; k++) differences += results[k] != expected[k];
+		batch->print_statistics();
+		cout << "access_batch: results differing = " << dec << differences
+			 << ", same statistics = " << (same_statistics(single, batch) ? "yes" : "no") << endl;
+		delete single;
+		delete batch;
+
+		// the reads, then the writes
+		single = new cache(size[i], assoc[i], 64, hit_policy[i], miss_policy[i], 5, 100, 32);
+		batch = new cache(size[i], assoc[i], 64, hit_policy[i], miss_policy[i], 5, 100, 32);
+		for (unsigned k=0; k<read_count; k++) expected[k] = single->access(false, reads[k]);
+		for (unsigned k=0; k<write_count; k++) expected[read_count + k] = single->access(true, writes[k]);
+		batch->read_batch(reads, read_count, results);
+		batch->write_batch(writes, write_count, results + read_count);
+		differences = 0;
+		for (unsigned k=0; k<ACCESSES; k++) differences += results[k] != expected[k];
+		cout << "read_batch and write_batch: results differing = " << dec << differences
+			 << ", same statistics = " << (same_statistics(single, batch) ? "yes" : "no") << endl;
+
+		// without results
+		batch->access_batch(records, ACCESSES);
+		for (unsigned k=0; k<ACCESSES; k++) single->access(records[k].write, records[k].address);
+		cout << "access_batch without results: same statistics = " << (same_statistics(single, batch) ? "yes" : "no") << endl;
+		delete single;
+		delete batch;
+
+		cout << endl;
+	}
+
+	delete [] records;
+	delete [] reads;
+	delete [] writes;
+	delete [] expected;
+	delete [] results;
+}
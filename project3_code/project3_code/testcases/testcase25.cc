@@ -0,0 +1,96 @@
+#include "cache.h"
+#include "stack_distance.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+#include <set>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* fully-associative caches (associativity 0): the LRU misses of caches of 16 lines (ways
+ * scanned), 512 and 4096 lines (hashed tag index) against the stack distance simulator; then, for
+ * each replacement policy, the lines of a 512-line cache after a synthetic zipf stream, the
+ * invalidation of half of them, and the refill (the invalidated lines are filled before any
+ * eviction) */
+
+#define ACCESSES 200000
+#define REFILL 20000
+
+int main(int argc, char **argv){
+
+	workload_generator stream(ZIPF, 1024*KB, 0.25, 37);
+	trace_record_t *records = new trace_record_t[ACCESSES];
+	stream.read(records, ACCESSES);
+
+	cout << "LRU MISSES" << endl;
+	cout << "==========================================" << endl << endl;
+
+	stack_distance *engine = new stack_distance(64, 1, 4096);
+	for (unsigned k=0; k<ACCESSES; k++) engine->access(records[k].write, records[k].address);
+
+	unsigned lines[] = {16, 512, 4096};
+	for (unsigned i=0; i<3; i++){
+		cache *mycache = new cache(lines[i]*64, 0, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+		if (i == 1) mycache->print_configuration();
+		mycache->run(records, ACCESSES);
+		cout << dec << lines[i] << " lines: misses = " << mycache->get_misses()
+			 << ", stack distance misses = " << engine->get_misses(1, lines[i]) << endl;
+		delete mycache;
+	}
+	cout << endl;
+	delete engine;
+
+	replacement_policy_t policy[] = {LRU, PLRU_TREE, PLRU_BIT, FIFO, RANDOM, SRRIP, BRRIP};
+
+	for (unsigned p=0; p<7; p++){
+
+		cout << replacement_policy_name(policy[p]) << endl;
+		cout << "==========================================" << endl << endl;
+
+		cache *mycache = new cache(32*KB, 0, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32, policy[p]);
+		mycache->run(records, ACCESSES - REFILL);
+
+		// every line held is found, and is one of the blocks accessed
+		vector<address_t> held;
+		mycache->get_lines(held);
+		set<address_t> accessed;
+		for (unsigned k=0; k<ACCESSES - REFILL; k++) accessed.insert(records[k].address >> 6);
+		unsigned found = 0, known = 0;
+		for (unsigned k=0; k<held.size(); k++){
+			found += mycache->probe(held[k]);
+			known += accessed.count(held[k] >> 6);
+		}
+		cout << "lines held = " << dec << held.size() << ", found = " << found << ", accessed = " << known << endl;
+
+		// invalidate every other line
+		unsigned invalidated = 0, dirty = 0, still = 0;
+		for (unsigned k=0; k<held.size(); k+=2){
+			bool was_dirty;
+			invalidated += mycache->invalidate(held[k], was_dirty);
+			dirty += was_dirty;
+		}
+		for (unsigned k=0; k<held.size(); k++) still += mycache->probe(held[k]);
+		cout << "invalidated = " << dec << invalidated << " (" << dirty << " dirty), lines still found = " << still << endl;
+
+		// the next misses fill the invalidated lines first
+		unsigned long long misses = mycache->get_misses(), evictions = mycache->get_evictions();
+		mycache->run(records + ACCESSES - REFILL, REFILL);
+		misses = mycache->get_misses() - misses;
+		evictions = mycache->get_evictions() - evictions;
+		held.clear();
+		mycache->get_lines(held);
+		cout << "refill: misses = " << dec << misses << ", evictions = " << evictions
+			 << ", misses without eviction = " << misses - evictions << ", lines held = " << held.size() << endl;
+
+		cout << endl;
+
+		delete mycache;
+	}
+
+	delete [] records;
+}
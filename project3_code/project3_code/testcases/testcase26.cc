@@ -0,0 +1,97 @@
+#include "cache.h"
+#include "workload.h"
+#include "prefetcher.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* hardware prefetchers: misses and prefetch statistics of a 16KB 4-way cache without prefetching
+ * and with the next-line, stride and stream prefetchers (degree 2), on synthetic sequential,
+ * strided (256B) and zipf streams with 20% writes; then the stream prefetcher on the sequential
+ * stream with a prefetch latency (late prefetches), and throttling: the degree of the stream
+ * prefetcher rises on the sequential stream, that of the next-line prefetcher falls on the zipf
+ * stream (useless prefetches) */
+
+#define ACCESSES 100000
+
+// prints the misses and the prefetch statistics of a cache
+void print_prefetching(const char *name, cache *c){
+	prefetch_stats_t st = c->get_prefetch_stats();
+	cout << name << ": misses = " << dec << c->get_misses() << ", issued = " << st.issued
+		 << ", useful = " << st.useful << ", useless = " << st.useless << ", late = " << st.late
+		 << ", redundant = " << st.redundant << ", dropped = " << st.dropped << ", pollution = " << st.pollution << endl;
+}
+
+int main(int argc, char **argv){
+
+	const char *title[] = {"SEQUENTIAL", "STRIDED", "ZIPF"};
+	workload_t type[] = {SEQUENTIAL, STRIDED, ZIPF};
+	prefetcher_t engine[] = {NO_PREFETCH, NEXT_LINE, STRIDE, STREAM};
+	trace_record_t *records = new trace_record_t[ACCESSES];
+
+	for (unsigned i=0; i<3; i++){
+
+		workload_generator stream(type[i], 1024*KB, 0.2, 41, 8, 256);
+		stream.read(records, ACCESSES);
+
+		cout << title[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		for (unsigned e=0; e<4; e++){
+			cache *mycache = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+			if (engine[e] != NO_PREFETCH) mycache->enable_prefetcher(engine[e], 2);
+			mycache->run(records, ACCESSES);
+			print_prefetching(prefetcher_name(engine[e]), mycache);
+			delete mycache;
+		}
+
+		cout << endl;
+	}
+
+	cout << "STREAM PREFETCHER LATENCY" << endl;
+	cout << "==========================================" << endl << endl;
+
+	workload_generator sequential(SEQUENTIAL, 1024*KB, 0.2, 41);
+	sequential.read(records, ACCESSES);
+
+	unsigned latency[] = {0, 4, 16, 64};
+	for (unsigned l=0; l<4; l++){
+		cache *mycache = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+		mycache->enable_prefetcher(STREAM, 2, false, latency[l]);
+		mycache->run(records, ACCESSES);
+		stringstream name;
+		name << "latency " << latency[l];
+		print_prefetching(name.str().c_str(), mycache);
+		delete mycache;
+	}
+
+	cout << endl;
+
+	const char *throttled_title[] = {"STREAM PREFETCHER THROTTLING, SEQUENTIAL", "NEXT-LINE PREFETCHER THROTTLING, ZIPF"};
+	workload_t throttled_type[] = {SEQUENTIAL, ZIPF};
+	prefetcher_t throttled[] = {STREAM, NEXT_LINE};
+	for (unsigned i=0; i<2; i++){
+
+		cout << throttled_title[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		workload_generator stream(throttled_type[i], 1024*KB, 0.2, 41);
+		stream.read(records, ACCESSES);
+
+		cache *mycache = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+		mycache->enable_prefetcher(throttled[i], 4, true, 16);
+		mycache->run(records, ACCESSES);
+		mycache->print_statistics();
+		delete mycache;
+
+		cout << endl;
+	}
+
+	delete [] records;
+}
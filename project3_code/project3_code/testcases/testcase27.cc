@@ -0,0 +1,115 @@
+#include "cache.h"
+#include "workload.h"
+#include "interval_sampler.h"
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* interval statistics: a write-back and a write-through cache sample every 100 accesses of a
+ * synthetic zipf stream with 30% writes (more intervals than SAMPLER_RING, so the simulation may
+ * wait for the writer), to a CSV and to a binary file; the intervals must be contiguous, the last
+ * one partial, their sums equal to the statistics of the cache, and both files identical */
+
+#define ACCESSES 123456
+#define INTERVAL 100
+#define CSV "testcase27.csv"
+#define BINARY "testcase27.bin"
+
+int main(int argc, char **argv){
+
+	workload_generator stream(ZIPF, 256*KB, 0.3, 47);
+	trace_record_t *records = new trace_record_t[ACCESSES];
+	stream.read(records, ACCESSES);
+
+	write_policy_t hit_policy[] = {WRITE_BACK, WRITE_THROUGH};
+
+	for (unsigned i=0; i<2; i++){
+
+		cout << (i == 0 ? "WRITE-BACK" : "WRITE-THROUGH") << endl;
+		cout << "==========================================" << endl << endl;
+
+		cache *csv = new cache(16*KB, 4, 64, hit_policy[i], WRITE_ALLOCATE, 5, 100, 32);
+		cache *binary = new cache(16*KB, 4, 64, hit_policy[i], WRITE_ALLOCATE, 5, 100, 32);
+		csv->enable_interval_stats(INTERVAL, CSV);
+		binary->enable_interval_stats(INTERVAL, BINARY, true);
+		// in pieces that do not end on an interval boundary
+		for (unsigned first=0; first<ACCESSES; first+=7777){
+			unsigned count = ACCESSES - first < 7777 ? ACCESSES - first : 7777;
+			csv->run(records + first, count);
+			for (unsigned k=first; k<first+count; k++) binary->access(records[k].write, records[k].address);
+		}
+		csv->close_interval_stats();
+		binary->close_interval_stats();
+
+		// CSV file: header, then one line per interval
+		ifstream in(CSV);
+		string line;
+		getline(in, line);
+		cout << line << endl;
+		vector<interval_sample_t> rows;
+		while (getline(in, line)){
+			interval_sample_t row;
+			double miss_rate;
+			if (sscanf(line.c_str(), "%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lf,%lf", &row.index, &row.first_access,
+					   &row.accesses, &row.reads, &row.read_misses, &row.writes, &row.write_misses, &row.evictions,
+					   &row.memory_writes, &miss_rate, &row.amat) != 11) break;
+			if (rows.size() < 3) cout << line << endl;
+			rows.push_back(row);
+		}
+		in.close();
+		cout << "..." << endl;
+		cout << "intervals = " << dec << rows.size() << ", last interval accesses = " << rows.back().accesses << endl;
+
+		unsigned contiguous = 0;
+		uint64_t accesses = 0, misses = 0, evictions = 0, memory_writes = 0;
+		for (unsigned k=0; k<rows.size(); k++){
+			contiguous += rows[k].index == k && rows[k].first_access == accesses
+						  && rows[k].reads + rows[k].writes == rows[k].accesses;
+			accesses += rows[k].accesses;
+			misses += rows[k].read_misses + rows[k].write_misses;
+			evictions += rows[k].evictions;
+			memory_writes += rows[k].memory_writes;
+		}
+		cout << "contiguous intervals = " << dec << contiguous << endl;
+		cout << "sums: accesses = " << accesses << ", misses = " << misses << ", evictions = " << evictions
+			 << ", memory writes = " << memory_writes << endl;
+		csv->print_statistics();
+
+		// binary file: header, then the same samples
+		FILE *file = fopen(BINARY, "rb");
+		interval_header_t header;
+		bool valid = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, INTERVAL_MAGIC, 4) == 0
+					 && header.version == INTERVAL_VERSION && header.interval == INTERVAL;
+		unsigned samples = 0, same = 0;
+		interval_sample_t sample;
+		while (fread(&sample, sizeof(sample), 1, file) == 1){
+			if (samples < rows.size())
+				same += sample.index == rows[samples].index && sample.first_access == rows[samples].first_access
+						&& sample.accesses == rows[samples].accesses && sample.read_misses == rows[samples].read_misses
+						&& sample.write_misses == rows[samples].write_misses && sample.evictions == rows[samples].evictions
+						&& sample.memory_writes == rows[samples].memory_writes;
+			samples++;
+		}
+		fclose(file);
+		cout << "binary header valid = " << (valid ? "yes" : "no") << ", samples = " << dec << samples
+			 << ", same as the CSV = " << same << endl;
+
+		cout << endl;
+
+		delete csv;
+		delete binary;
+	}
+
+	remove(CSV);
+	remove(BINARY);
+	delete [] records;
+}
@@ -0,0 +1,128 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* per-set counters of an 8KB 4-way cache (32 sets) on a synthetic uniform stream with 25% writes,
+ * where every 4th access goes to one of 12 blocks of set 5 (a conflict hot spot): the sums of the
+ * counters equal the statistics of the cache, the hot-set report, the binary dump read back,
+ * run_parallel (same counters as a serial run) and a checkpoint round trip of the counters */
+
+#define ACCESSES 100000
+#define SETS 32
+#define TRACE "testcase28.trace"
+#define DUMP "testcase28.sets"
+#define CHECKPOINT "testcase28.ckpt"
+
+// returns true if the counters of the two caches are the same
+bool same_counters(cache *a, cache *b){
+	return memcmp(a->get_set_statistics(), b->get_set_statistics(), SETS * sizeof(set_stats_t)) == 0;
+}
+
+int main(int argc, char **argv){
+
+	workload_generator stream(UNIFORM, 64*KB, 0.25, 53);
+	trace_record_t *records = new trace_record_t[ACCESSES];
+	stream.read(records, ACCESSES);
+	for (unsigned k=3; k<ACCESSES; k+=4) records[k].address = 0x20000000 + ((k / 4) % 12) * SETS * 64 + 5 * 64;
+
+	// the same stream as a trace file, for run_parallel
+	FILE *out = fopen(TRACE, "w");
+	for (unsigned k=0; k<ACCESSES; k++) fprintf(out, "%c 0x%llx\n", records[k].write ? 'w' : 'r', records[k].address);
+	fclose(out);
+
+	cout << "PER-SET COUNTERS" << endl;
+	cout << "==========================================" << endl << endl;
+
+	cache *mycache = new cache(8*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+	cout << "counters before enabling = " << (mycache->get_set_statistics() == NULL ? "none" : "some") << endl;
+	mycache->enable_set_statistics();
+	mycache->run(records, ACCESSES);
+
+	const set_stats_t *sets = mycache->get_set_statistics();
+	unsigned long long accesses = 0, misses = 0, evictions = 0, write_backs = 0;
+	for (unsigned s=0; s<SETS; s++){
+		accesses += sets[s].accesses;
+		misses += sets[s].misses;
+		evictions += sets[s].evictions;
+		write_backs += sets[s].write_backs;
+	}
+	cout << "sums: accesses = " << dec << accesses << ", misses = " << misses << ", evictions = " << evictions
+		 << ", write backs = " << write_backs << endl;
+	cout << "set 5: accesses = " << dec << sets[5].accesses << ", misses = " << sets[5].misses
+		 << ", evictions = " << sets[5].evictions << endl;
+	mycache->print_statistics();
+	cout << endl;
+
+	cout << "HOT SETS" << endl;
+	cout << "==========================================" << endl << endl;
+
+	mycache->print_set_statistics(3);
+	cout << endl;
+
+	cout << "DUMP" << endl;
+	cout << "==========================================" << endl << endl;
+
+	bool dumped = mycache->dump_set_statistics(DUMP);
+	FILE *file = fopen(DUMP, "rb");
+	set_dump_header_t header;
+	set_stats_t *dump = new set_stats_t[SETS + 1];
+	bool valid = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, SET_DUMP_MAGIC, 4) == 0
+				 && header.version == SET_DUMP_VERSION;
+	size_t records_read = fread(dump, sizeof(set_stats_t), SETS + 1, file);
+	fclose(file);
+	cout << "dumped = " << (dumped ? "yes" : "no") << ", header valid = " << (valid ? "yes" : "no")
+		 << ", sets = " << dec << header.sets << ", associativity = " << header.associativity
+		 << ", records = " << records_read << endl;
+	cout << "records equal to the counters = "
+		 << (records_read == SETS && memcmp(dump, sets, SETS * sizeof(set_stats_t)) == 0 ? "yes" : "no") << endl;
+	cache *disabled = new cache(8*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+	cout << "dump without counters = " << (disabled->dump_set_statistics(DUMP) ? "written" : "refused") << endl;
+	cout << endl;
+
+	cout << "RUN_PARALLEL" << endl;
+	cout << "==========================================" << endl << endl;
+
+	cache *parallel = new cache(8*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+	parallel->enable_set_statistics();
+	parallel->load_trace(TRACE);
+	parallel->run_parallel(4);
+	cout << "same counters as the serial run = " << (same_counters(parallel, mycache) ? "yes" : "no") << endl;
+	cout << endl;
+
+	cout << "CHECKPOINT" << endl;
+	cout << "==========================================" << endl << endl;
+
+	cache *first = new cache(8*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+	first->enable_set_statistics();
+	first->run(records, ACCESSES / 2);
+	bool saved = first->save_checkpoint(CHECKPOINT);
+	cache *second = new cache(8*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+	second->enable_set_statistics();
+	bool loaded = second->load_checkpoint(CHECKPOINT);
+	cout << "saved = " << (saved ? "yes" : "no") << ", loaded = " << (loaded ? "yes" : "no")
+		 << ", same counters = " << (same_counters(first, second) ? "yes" : "no") << endl;
+	second->run(records + ACCESSES / 2, ACCESSES - ACCESSES / 2);
+	cout << "same counters as the whole run after the second half = "
+		 << (same_counters(second, mycache) ? "yes" : "no") << endl;
+
+	remove(TRACE);
+	remove(DUMP);
+	remove(CHECKPOINT);
+	delete mycache;
+	delete disabled;
+	delete parallel;
+	delete first;
+	delete second;
+	delete [] dump;
+	delete [] records;
+}
@@ -0,0 +1,91 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* 64-bit counters and long traces: a checkpoint whose access and read counters are moved past 2^32
+ * is restored and simulated further (the counters do not wrap); then a synthetic zipf trace larger
+ * than TRACE_RELEASE is streamed from the file in chunks of "run", with and without the
+ * background reader (same statistics as the stream simulated from memory) */
+
+#define CHECKPOINT "testcase29.ckpt"
+#define TRACE "testcase29.trace"
+#define ACCESSES 6000000ULL
+#define CHUNK 1000000ULL
+
+// returns true if the statistics of the two caches are the same
+bool same_statistics(cache *a, cache *b){
+	return a->get_memory_accesses() == b->get_memory_accesses() && a->get_misses() == b->get_misses()
+		&& a->get_evictions() == b->get_evictions() && a->num_of_mem_writes() == b->num_of_mem_writes();
+}
+
+int main(int argc, char **argv){
+
+	cout << "COUNTERS PAST 2^32" << endl;
+	cout << "==========================================" << endl << endl;
+
+	workload_generator stream(ZIPF, 256*KB, 0.25, 59);
+	cache *first = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+	stream.run(first, 1000);
+	first->save_checkpoint(CHECKPOINT);
+
+	// the statistics follow the header of the checkpoint
+	fstream file(CHECKPOINT, ios::in | ios::out | ios::binary);
+	cache_stats_t st;
+	file.seekg(sizeof(checkpoint_header_t));
+	file.read((char *) &st, sizeof(st));
+	st.number_memory_accesses += 1ULL << 32;
+	st.number_reads += 1ULL << 32;
+	file.seekp(sizeof(checkpoint_header_t));
+	file.write((const char *) &st, sizeof(st));
+	file.close();
+
+	cache *second = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+	cout << "loaded = " << (second->load_checkpoint(CHECKPOINT) ? "yes" : "no") << endl;
+	stream.run(second, 1000);
+	second->print_statistics();
+	cout << endl;
+
+	cout << "STREAMING" << endl;
+	cout << "==========================================" << endl << endl;
+
+	stream.reset();
+	stream.write_trace(TRACE, ACCESSES);
+	ifstream trace(TRACE, ios::binary | ios::ate);
+	cout << "trace larger than TRACE_RELEASE = " << ((unsigned long long) trace.tellg() > TRACE_RELEASE ? "yes" : "no") << endl;
+	trace.close();
+
+	cache *memory = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+	stream.reset();
+	stream.run(memory, ACCESSES);
+	memory->print_statistics();
+
+	for (unsigned background=0; background<2; background++){
+		cache *streamed = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 32);
+		streamed->load_trace(TRACE, background);
+		unsigned chunks = 0;
+		while (streamed->get_memory_accesses() < ACCESSES){
+			streamed->run(CHUNK);
+			chunks++;
+		}
+		streamed->run();
+		cout << (background ? "background reader" : "reader") << ": chunks = " << dec << chunks
+			 << ", same statistics = " << (same_statistics(streamed, memory) ? "yes" : "no") << endl;
+		delete streamed;
+	}
+
+	remove(CHECKPOINT);
+	remove(TRACE);
+	delete first;
+	delete second;
+	delete memory;
+}
@@ -0,0 +1,66 @@
+#include "cache_group.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* same configurations as testcase3, simulated with a single pass over the trace */
+
+int main(int argc, char **argv){
+
+	const char *title[] = {
+		"WRITE-BACK/WRITE-ALLOCATE",
+		"WRITE-THROUGH/NO-WRITE-ALLOCATE",
+		"WRITE-BACK/NO-WRITE-ALLOCATE",
+		"WRITE-THROUGH/WRITE-ALLOCATE"
+	};
+	const char *underline[] = {
+		"=========================",
+		"===============================",
+		"============================",
+		"============================"
+	};
+	write_policy_t hit_policy[] = {WRITE_BACK, WRITE_THROUGH, WRITE_BACK, WRITE_THROUGH};
+	write_policy_t miss_policy[] = {WRITE_ALLOCATE, NO_WRITE_ALLOCATE, NO_WRITE_ALLOCATE, WRITE_ALLOCATE};
+
+	cache_group *group = new cache_group();
+
+	for (unsigned i=0; i<4; i++){
+		cache_config_t config = {64*KB,			//size
+					 1,			//associativity
+					 64,			//cache line size
+					 hit_policy[i],		//write hit policy
+					 miss_policy[i], 	//write miss policy
+					 5, 			//hit time
+					 100, 			//miss penalty
+					 48    		//address width
+					 };
+		group->add(config);
+	}
+
+	group->load_trace("traces/GCC.t");
+
+	group->run();
+
+	for (unsigned i=0; i<group->size(); i++){
+
+	cout << title[i] << endl;
+	cout << underline[i] << endl << endl;
+
+	group->get(i)->print_configuration();
+
+	cout << endl;
+
+	group->get(i)->print_statistics();
+
+	cout << endl;
+
+	}
+
+	delete group;
+}
@@ -0,0 +1,65 @@
+#include "cache_hierarchy.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* two-level hierarchy in each inclusion mode, with a write-back/write-allocate and a
+ * write-through/no-write-allocate L1, on a synthetic zipf stream with 30% writes; the
+ * lines breaking the inclusion policy are counted every 1000 accesses (always 0) */
+
+#define ACCESSES 100000
+#define CHECK 1000
+
+int main(int argc, char **argv){
+
+	const char *title[] = {"NON-INCLUSIVE", "INCLUSIVE", "EXCLUSIVE"};
+	inclusion_policy_t inclusion[] = {NON_INCLUSIVE, INCLUSIVE, EXCLUSIVE};
+	write_policy_t hit_policy[] = {WRITE_BACK, WRITE_THROUGH};
+	write_policy_t miss_policy[] = {WRITE_ALLOCATE, NO_WRITE_ALLOCATE};
+
+	for (unsigned i=0; i<3; i++){
+		for (unsigned j=0; j<2; j++){
+
+		cache_config_t l1 = {8*KB,			//size
+				     2,			//associativity
+				     64,			//cache line size
+				     hit_policy[j],		//write hit policy
+				     miss_policy[j], 	//write miss policy
+				     2, 			//hit time
+				     10, 			//miss penalty
+				     48    		//address width
+				     };
+		cache_config_t l2 = {32*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 10, 100, 48};
+
+		cache_hierarchy *hierarchy = new cache_hierarchy(inclusion[i]);
+		hierarchy->add_level(l1);
+		hierarchy->add_level(l2);
+
+		workload_generator stream(ZIPF, 256*KB, 0.3, 7);
+		trace_record_t records[CHECK];
+		unsigned long long violations = 0;
+		for (unsigned n=0; n<ACCESSES; n+=CHECK){
+			stream.read(records, CHECK);
+			for (unsigned k=0; k<CHECK; k++) hierarchy->access(records[k].write, records[k].address);
+			violations += hierarchy->check_inclusion();
+		}
+
+		cout << title[i] << " (L1 " << (j ? "WRITE-THROUGH/NO-WRITE-ALLOCATE" : "WRITE-BACK/WRITE-ALLOCATE") << ")" << endl;
+		cout << "==========================================" << endl << endl;
+
+		hierarchy->print_statistics();
+		cout << "inclusion violations = " << dec << violations << endl;
+
+		cout << endl;
+
+		delete hierarchy;
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* direct-mapped cache with an 8-entry victim cache and with an 8-entry miss cache, for each
+ * write policy, on a synthetic zipf stream with 30% writes */
+
+#define ACCESSES 200000
+
+int main(int argc, char **argv){
+
+	const char *title[] = {
+		"WRITE-BACK/WRITE-ALLOCATE",
+		"WRITE-THROUGH/NO-WRITE-ALLOCATE",
+		"WRITE-BACK/NO-WRITE-ALLOCATE",
+		"WRITE-THROUGH/WRITE-ALLOCATE"
+	};
+	write_policy_t hit_policy[] = {WRITE_BACK, WRITE_THROUGH, WRITE_BACK, WRITE_THROUGH};
+	write_policy_t miss_policy[] = {WRITE_ALLOCATE, NO_WRITE_ALLOCATE, NO_WRITE_ALLOCATE, WRITE_ALLOCATE};
+
+	for (unsigned m=0; m<2; m++){
+		for (unsigned i=0; i<4; i++){
+
+		cache *mycache = new cache(4*KB,		//size
+					  1,			//associativity
+					  64,			//cache line size
+					  hit_policy[i],		//write hit policy
+					  miss_policy[i], 	//write miss policy
+					  5, 			//hit time
+					  100, 			//miss penalty
+					  48    		//address width
+					  );
+		mycache->attach_victim_cache(8, m == 1, 1);
+
+		workload_generator stream(ZIPF, 64*KB, 0.3, 3);
+		stream.run(mycache, ACCESSES);
+
+		cout << (m ? "MISS CACHE, " : "VICTIM CACHE, ") << title[i] << endl;
+		cout << "==========================================" << endl << endl;
+
+		mycache->print_statistics();
+
+		cout << endl;
+
+		delete mycache;
+		}
+	}
+}
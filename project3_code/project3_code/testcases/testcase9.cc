@@ -0,0 +1,59 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sstream>
+
+#define KB 1024
+
+using namespace std;
+
+/* Test case for cache simulator */ 
+
+/* checkpoint round trip: a cache simulates the first half of a synthetic stream and saves its
+ * state, a second cache restores it and simulates the second half; its statistics must match
+ * those of a cache simulating the whole stream (for each replacement policy with state) */
+
+#define ACCESSES 200000
+#define CHECKPOINT "testcase9.ckpt"
+
+int main(int argc, char **argv){
+
+	replacement_policy_t policy[] = {LRU, PLRU_TREE, FIFO, DRRIP};
+
+	workload_generator stream(UNIFORM, 128*KB, 0.3, 5);
+	trace_record_t *records = new trace_record_t[ACCESSES];
+	stream.read(records, ACCESSES);
+
+	for (unsigned i=0; i<4; i++){
+
+		cache *serial = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48, policy[i]);
+		cache *first = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48, policy[i]);
+		cache *second = new cache(16*KB, 4, 64, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48, policy[i]);
+
+		serial->run(records, ACCESSES);
+		first->run(records, ACCESSES/2);
+		bool saved = first->save_checkpoint(CHECKPOINT);
+		bool loaded = second->load_checkpoint(CHECKPOINT);
+		second->run(records + ACCESSES/2, ACCESSES - ACCESSES/2);
+
+		cout << replacement_policy_name(policy[i]) << endl;
+		cout << "==========================================" << endl << endl;
+
+		cout << "checkpoint saved = " << (saved ? "yes" : "no") << ", loaded = " << (loaded ? "yes" : "no") << endl;
+		cout << "same statistics as the serial run = "
+			 << (second->get_misses() == serial->get_misses() && second->get_evictions() == serial->get_evictions() &&
+				 second->num_of_mem_writes() == serial->num_of_mem_writes() ? "yes" : "no") << endl << endl;
+
+		second->print_statistics();
+
+		cout << endl;
+
+		delete serial;
+		delete first;
+		delete second;
+	}
+	remove(CHECKPOINT);
+	delete [] records;
+}
@@ -0,0 +1,97 @@
+#include "thread_pool.h"
+
+using namespace std;
+
+thread_pool::thread_pool(unsigned threads){
+	if(threads == 0) threads = thread::hardware_concurrency();
+	if(threads == 0) threads = 1;
+
+	queued = 0;
+	pending = 0;
+	next_queue = 0;
+	stopping = false;
+
+	for(unsigned i = 0; i < threads; i++) queues.push_back(new task_queue_t);
+	for(unsigned i = 0; i < threads; i++) workers.push_back(thread(&thread_pool::worker, this, i));
+}
+
+thread_pool::~thread_pool(){
+	wait();
+	{
+		unique_lock<mutex> l(state_lock);
+		stopping = true;
+	}
+	work_available.notify_all();
+	for(unsigned i = 0; i < workers.size(); i++) workers[i].join();
+	for(unsigned i = 0; i < queues.size(); i++) delete queues[i];
+}
+
+unsigned thread_pool::size(){
+	return workers.size();
+}
+
+void thread_pool::submit(const function<void()> &task){
+	unsigned id;
+	{
+		unique_lock<mutex> l(state_lock);
+		id = next_queue;
+		next_queue = (next_queue + 1) % queues.size();
+	}
+	{
+		unique_lock<mutex> l(queues[id]->lock);
+		queues[id]->tasks.push_back(task);
+	}
+	{
+		unique_lock<mutex> l(state_lock);
+		queued++;
+		pending++;
+	}
+	work_available.notify_one();
+}
+
+void thread_pool::wait(){
+	unique_lock<mutex> l(state_lock);
+	while(pending != 0) work_done.wait(l);
+}
+
+bool thread_pool::take(unsigned id, function<void()> &task){
+	// own queue first (most recently submitted task)
+	{
+		task_queue_t *q = queues[id];
+		unique_lock<mutex> l(q->lock);
+		if(!q->tasks.empty()){
+			task = q->tasks.back();
+			q->tasks.pop_back();
+			return true;
+		}
+	}
+	// steal the oldest task of another worker
+	for(unsigned i = 1; i < queues.size(); i++){
+		task_queue_t *q = queues[(id + i) % queues.size()];
+		unique_lock<mutex> l(q->lock);
+		if(!q->tasks.empty()){
+			task = q->tasks.front();
+			q->tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void thread_pool::worker(unsigned id){
+	while(true){
+		{
+			unique_lock<mutex> l(state_lock);
+			while(queued == 0 && !stopping) work_available.wait(l);
+			if(queued == 0 && stopping) return;
+			queued--; // a task is reserved for this worker, take() will find it
+		}
+
+		function<void()> task;
+		while(!take(id, task));
+		task();
+
+		unique_lock<mutex> l(state_lock);
+		if(--pending == 0) work_done.notify_all();
+	}
+}
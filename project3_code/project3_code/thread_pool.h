@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+/* Work-stealing thread pool
+ * each worker runs the tasks of its own queue (newest first) and, when it is empty,
+ * steals the oldest task of another worker's queue */
+class thread_pool{
+
+	typedef struct{
+		mutex lock;
+		deque< function<void()> > tasks;
+	} task_queue_t;
+
+	vector<thread> workers;
+	vector<task_queue_t *> queues;
+
+	mutex state_lock;
+	condition_variable work_available;
+	condition_variable work_done;
+	unsigned queued;		// tasks waiting in the queues
+	unsigned pending;		// tasks submitted and not completed
+	unsigned next_queue;	// queue receiving the next submitted task
+	bool stopping;
+
+	// takes a task from the worker's queue or steals one; returns false if all queues are empty
+	bool take(unsigned id, function<void()> &task);
+
+	// main loop of the worker threads
+	void worker(unsigned id);
+
+public:
+
+	// starts "threads" workers; 0 (default) starts one worker per hardware thread
+	thread_pool(unsigned threads=0);
+
+	// waits for the submitted tasks and stops the workers
+	~thread_pool();
+
+	// returns the number of workers
+	unsigned size();
+
+	// queues a task
+	void submit(const function<void()> &task);
+
+	// waits until all the submitted tasks have completed
+	void wait();
+};
+
+#endif /*THREAD_POOL_H_*/
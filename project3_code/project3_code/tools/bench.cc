@@ -0,0 +1,223 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KB 1024
+
+using namespace std;
+
+/* Measures the simulation throughput (memory accesses per second) of a matrix of cache
+ * configurations, through cache::access (one call per access, i.e., read/write) and cache::run (batched)
+ * the accesses are generated (or decoded) before timing, so that no trace I/O is measured
+ * build with "make bench" (optimized build) */
+
+typedef enum {MODE_ACCESS, MODE_RUN} bench_mode_t;
+
+static const char *mode_names[] = {"access", "run"};
+
+// statistics of the repetitions of one configuration (accesses per second)
+typedef struct{
+	unsigned associativity;
+	unsigned line_size;
+	replacement_policy_t policy;
+	bench_mode_t mode;
+	double mean, stddev, min, median, max;
+	double miss_rate;
+} bench_result_t;
+
+static void usage(const char *prog){
+	cerr << "usage: " << prog << " [options]" << endl;
+	cerr << "  -f <trace>          simulate a trace file instead of a synthetic workload" << endl;
+	cerr << "  -p <pattern>        synthetic workload: sequential, strided, uniform, zipf, pointer-chase" << endl;
+	cerr << "                      (default: zipf)" << endl;
+	cerr << "  -k <KB>             footprint of the synthetic workload (default: 4096)" << endl;
+	cerr << "  -n <accesses>       accesses of the synthetic workload (default: 2000000)" << endl;
+	cerr << "  -s <KB>             cache size (default: 32)" << endl;
+	cerr << "  -a <list>           associativities, comma separated (default: 1,4,16)" << endl;
+	cerr << "  -l <list>           line sizes, comma separated (default: 32,64)" << endl;
+	cerr << "  -r <list>           replacement policies, comma separated (default: lru,tree-plru,srrip)" << endl;
+	cerr << "  -m <list>           interfaces: access (one call per access), run (batched) (default: access,run)" << endl;
+	cerr << "  -u <count>          warm-up runs per configuration, not measured (default: 1)" << endl;
+	cerr << "  -i <count>          measured repetitions per configuration (default: 5)" << endl;
+	cerr << "  -j                  JSON output (default: CSV)" << endl;
+}
+
+// splits a comma separated list
+static vector<string> split(const char *list){
+	vector<string> items;
+	string item;
+	for(const char *p = list; ; p++){
+		if(*p == ',' || *p == 0){
+			if(!item.empty()) items.push_back(item);
+			item.clear();
+			if(*p == 0) break;
+		}else item += *p;
+	}
+	return items;
+}
+
+// simulates the accesses on a new cache; returns the elapsed time (in seconds)
+static double simulate(const vector<trace_record_t> &records, unsigned size, unsigned associativity,
+					   unsigned line_size, replacement_policy_t policy, bench_mode_t mode, double &miss_rate){
+	cache *c = new cache(size, associativity, line_size, WRITE_BACK, WRITE_ALLOCATE, 5, 100, 48, policy);
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if(mode == MODE_ACCESS){
+		for(size_t i = 0; i < records.size(); i++) c->access(records[i].write, records[i].address);
+	}else{
+		c->run(records.data(), records.size());
+	}
+	chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+
+	miss_rate = (double) c->get_misses() / records.size();
+	delete c;
+	return chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char **argv){
+
+	const char *trace = NULL;
+	workload_t pattern = ZIPF;
+	uint64_t footprint = 4096, accesses = 2000000;
+	unsigned size = 32;
+	vector<string> assoc_list = split("1,4,16");
+	vector<string> line_list = split("32,64");
+	vector<string> policy_list = split("lru,tree-plru,srrip");
+	vector<string> mode_list = split("access,run");
+	unsigned warmups = 1, repetitions = 5;
+	bool json = false;
+
+	for(int arg = 1; arg < argc; arg++){
+		const char *opt = argv[arg];
+		if(strcmp(opt, "-j") == 0){
+			json = true;
+			continue;
+		}
+		if(strlen(opt) != 2 || opt[0] != '-' || arg + 1 >= argc){
+			usage(argv[0]);
+			return 1;
+		}
+		const char *v = argv[++arg];
+		switch(opt[1]){
+			case 'f': trace = v; break;
+			case 'p':
+				if(!parse_workload(v, pattern)){
+					usage(argv[0]);
+					return 1;
+				}
+				break;
+			case 'k': footprint = strtoull(v, NULL, 0); break;
+			case 'n': accesses = strtoull(v, NULL, 0); break;
+			case 's': size = atoi(v); break;
+			case 'a': assoc_list = split(v); break;
+			case 'l': line_list = split(v); break;
+			case 'r': policy_list = split(v); break;
+			case 'm': mode_list = split(v); break;
+			case 'u': warmups = atoi(v); break;
+			case 'i': repetitions = atoi(v); break;
+			default: usage(argv[0]); return 1;
+		}
+	}
+	if(repetitions == 0) repetitions = 1;
+
+	vector<replacement_policy_t> policies;
+	for(size_t i = 0; i < policy_list.size(); i++){
+		replacement_policy_t policy;
+		if(!parse_replacement_policy(policy_list[i].c_str(), policy) || policy == OPT){
+			usage(argv[0]);
+			return 1;
+		}
+		policies.push_back(policy);
+	}
+	vector<bench_mode_t> modes;
+	for(size_t i = 0; i < mode_list.size(); i++){
+		if(mode_list[i] == "access") modes.push_back(MODE_ACCESS);
+		else if(mode_list[i] == "run") modes.push_back(MODE_RUN);
+		else{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	// the accesses are prepared once, outside of the measurements
+	vector<trace_record_t> records;
+	if(trace != NULL){
+		trace_buffer buffer;
+		if(!buffer.load(trace)) return 1;
+		records.assign(buffer.data(), buffer.data() + buffer.size());
+	}else{
+		workload_generator workload(pattern, footprint * KB, 0.3);
+		records.resize(accesses);
+		workload.read(records.data(), records.size());
+	}
+	if(records.empty()){
+		cerr << "error: no memory access to simulate" << endl;
+		return 1;
+	}
+
+	vector<bench_result_t> results;
+	for(size_t a = 0; a < assoc_list.size(); a++){
+		for(size_t l = 0; l < line_list.size(); l++){
+			for(size_t p = 0; p < policies.size(); p++){
+				for(size_t m = 0; m < modes.size(); m++){
+					bench_result_t r;
+					r.associativity = atoi(assoc_list[a].c_str());
+					r.line_size = atoi(line_list[l].c_str());
+					r.policy = policies[p];
+					r.mode = modes[m];
+
+					for(unsigned i = 0; i < warmups; i++)
+						simulate(records, size*KB, r.associativity, r.line_size, r.policy, r.mode, r.miss_rate);
+
+					vector<double> rates;
+					for(unsigned i = 0; i < repetitions; i++){
+						double seconds = simulate(records, size*KB, r.associativity, r.line_size, r.policy, r.mode, r.miss_rate);
+						rates.push_back(records.size() / seconds);
+					}
+
+					sort(rates.begin(), rates.end());
+					double sum = 0, squares = 0;
+					for(size_t i = 0; i < rates.size(); i++) sum += rates[i];
+					r.mean = sum / rates.size();
+					for(size_t i = 0; i < rates.size(); i++) squares += (rates[i] - r.mean) * (rates[i] - r.mean);
+					r.stddev = rates.size() > 1 ? sqrt(squares / (rates.size() - 1)) : 0;
+					r.min = rates.front();
+					r.max = rates.back();
+					r.median = rates.size() % 2 ? rates[rates.size()/2] : (rates[rates.size()/2 - 1] + rates[rates.size()/2]) / 2;
+					results.push_back(r);
+				}
+			}
+		}
+	}
+
+	// accesses per second
+	if(json){
+		cout << "{\"accesses\": " << records.size() << ", \"size_kb\": " << size
+			 << ", \"repetitions\": " << repetitions << ", \"results\": [" << endl;
+		for(size_t i = 0; i < results.size(); i++){
+			const bench_result_t &r = results[i];
+			cout << "  {\"associativity\": " << r.associativity << ", \"line_size\": " << r.line_size
+				 << ", \"policy\": \"" << replacement_policy_name(r.policy) << "\", \"mode\": \"" << mode_names[r.mode]
+				 << "\", \"miss_rate\": " << r.miss_rate << ", \"mean\": " << r.mean << ", \"stddev\": " << r.stddev
+				 << ", \"min\": " << r.min << ", \"median\": " << r.median << ", \"max\": " << r.max << "}"
+				 << (i + 1 < results.size() ? "," : "") << endl;
+		}
+		cout << "]}" << endl;
+	}else{
+		cout << "associativity,line_size,policy,mode,miss_rate,mean,stddev,min,median,max" << endl;
+		for(size_t i = 0; i < results.size(); i++){
+			const bench_result_t &r = results[i];
+			cout << r.associativity << "," << r.line_size << "," << replacement_policy_name(r.policy) << ","
+				 << mode_names[r.mode] << "," << r.miss_rate << "," << r.mean << "," << r.stddev << ","
+				 << r.min << "," << r.median << "," << r.max << endl;
+		}
+	}
+	return 0;
+}
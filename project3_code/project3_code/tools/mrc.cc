@@ -0,0 +1,51 @@
+#include "shards.h"
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#define KB 1024
+
+using namespace std;
+
+/* Prints the approximate LRU miss ratio curve of a trace, from a spatially sampled fraction of its blocks (SHARDS) */
+
+static void usage(const char *prog){
+	cerr << "usage: " << prog << " [options] <trace> <line size> <max size KB>" << endl;
+	cerr << "  -r <rate>     sampling rate of the blocks (default: 0.01)" << endl;
+	cerr << "  -s <blocks>   fixed-size sampling: track at most this many blocks (default: fixed rate)" << endl;
+}
+
+int main(int argc, char **argv){
+
+	double rate = 0.01;
+	unsigned max_blocks = 0;
+
+	int arg = 1;
+	for(; arg < argc && argv[arg][0] == '-'; arg += 2){
+		if(strlen(argv[arg]) != 2 || arg + 1 >= argc){
+			usage(argv[0]);
+			return 1;
+		}
+		switch(argv[arg][1]){
+			case 'r': rate = atof(argv[arg+1]); break;
+			case 's': max_blocks = atoi(argv[arg+1]); break;
+			default: usage(argv[0]); return 1;
+		}
+	}
+	if(argc - arg != 3 || rate <= 0 || rate > 1){
+		usage(argv[0]);
+		return 1;
+	}
+
+	unsigned line_size = atoi(argv[arg+1]);
+	if(line_size == 0 || (line_size & (line_size - 1)) != 0){
+		cerr << "error: the line size must be a power of two" << endl;
+		return 1;
+	}
+
+	shards sampler(line_size, rate, max_blocks);
+	sampler.load_trace(argv[arg]);
+	sampler.run();
+	sampler.print_statistics(strtoull(argv[arg+2], NULL, 0) * KB);
+	return 0;
+}
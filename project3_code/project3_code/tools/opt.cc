@@ -0,0 +1,84 @@
+#include "cache.h"
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#define KB 1024
+
+using namespace std;
+
+/* Simulates one cache configuration with LRU and with Belady's optimal replacement (OPT),
+ * and prints their misses side by side */
+
+static void usage(const char *prog){
+	cerr << "usage: " << prog << " [options] <trace> <size KB> <associativity> <line size>" << endl;
+	cerr << "  -r <policy>           policy compared with OPT (default: lru)" << endl;
+	cerr << "  -n                    no-write-allocate (default: write-allocate)" << endl;
+	cerr << "  -t <hit> <penalty>    hit time and miss penalty in cycles (default: 5 100)" << endl;
+	cerr << "  -w <bits>             memory address width (default: 48)" << endl;
+}
+
+// simulates the trace and prints one row of the comparison
+static void simulate(const char *trace, unsigned size, unsigned associativity, unsigned line_size,
+					 write_policy_t wr_miss_policy, unsigned hit_time, unsigned miss_penalty,
+					 unsigned address_width, replacement_policy_t policy){
+
+	cache *c = new cache(size, associativity, line_size, WRITE_BACK, wr_miss_policy,
+						 hit_time, miss_penalty, address_width, policy);
+	c->load_trace(trace);
+	c->run();
+
+	unsigned long long accesses = c->get_memory_accesses();
+	unsigned long long misses = c->get_misses();
+	cout << replacement_policy_name(policy) << "," << dec << accesses << "," << misses << ","
+		 << (accesses ? (double) misses / accesses : 0.0) << "," << c->get_average_access_time() << endl;
+	delete c;
+}
+
+int main(int argc, char **argv){
+
+	replacement_policy_t policy = LRU;
+	write_policy_t wr_miss_policy = WRITE_ALLOCATE;
+	unsigned hit_time = 5, miss_penalty = 100;
+	unsigned address_width = 48;
+
+	int arg = 1;
+	while(arg < argc && argv[arg][0] == '-'){
+		const char *opt = argv[arg];
+		if(strcmp(opt, "-n") == 0){
+			wr_miss_policy = NO_WRITE_ALLOCATE;
+			arg++;
+		}else if(strcmp(opt, "-r") == 0 && arg + 1 < argc){
+			if(!parse_replacement_policy(argv[arg+1], policy)){
+				usage(argv[0]);
+				return 1;
+			}
+			arg += 2;
+		}else if(strcmp(opt, "-t") == 0 && arg + 2 < argc){
+			hit_time = atoi(argv[arg+1]);
+			miss_penalty = atoi(argv[arg+2]);
+			arg += 3;
+		}else if(strcmp(opt, "-w") == 0 && arg + 1 < argc){
+			address_width = atoi(argv[arg+1]);
+			arg += 2;
+		}else{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if(argc - arg != 4){
+		usage(argv[0]);
+		return 1;
+	}
+
+	const char *trace = argv[arg];
+	unsigned size = atoi(argv[arg+1]) * KB;
+	unsigned associativity = atoi(argv[arg+2]);
+	unsigned line_size = atoi(argv[arg+3]);
+
+	cout << "replacement_policy,accesses,misses,miss_rate,amat" << endl;
+	simulate(trace, size, associativity, line_size, wr_miss_policy, hit_time, miss_penalty, address_width, policy);
+	if(policy != OPT)
+		simulate(trace, size, associativity, line_size, wr_miss_policy, hit_time, miss_penalty, address_width, OPT);
+	return 0;
+}
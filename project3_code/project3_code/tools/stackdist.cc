@@ -0,0 +1,27 @@
+#include "stack_distance.h"
+#include <iostream>
+#include <stdlib.h>
+
+using namespace std;
+
+/* Prints the LRU misses of all power-of-two cache geometries sharing a line size, from one trace pass */
+
+int main(int argc, char **argv){
+
+	if(argc != 5){
+		cerr << "usage: " << argv[0] << " <trace> <line size> <max sets> <max associativity>" << endl;
+		return 1;
+	}
+
+	stack_distance *sd = new stack_distance(atoi(argv[2]),		//cache line size
+											atoi(argv[3]),		//largest number of sets
+											atoi(argv[4])		//largest associativity
+											);
+
+	sd->load_trace(argv[1]);
+	sd->run();
+	sd->print_statistics();
+
+	delete sd;
+	return 0;
+}
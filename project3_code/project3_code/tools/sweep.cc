@@ -0,0 +1,77 @@
+#include "cache_sweep.h"
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#define KB 1024
+
+using namespace std;
+
+/* Simulates a grid of cache configurations on all cores and prints one CSV row per configuration */
+
+static void usage(const char *prog){
+	cerr << "usage: " << prog << " [options] <trace>" << endl;
+	cerr << "  -j <threads>          worker threads (default: one per hardware thread)" << endl;
+	cerr << "  -s <min KB> <max KB>  cache sizes (default: 1 1024)" << endl;
+	cerr << "  -a <min> <max>        associativities (default: 1 16)" << endl;
+	cerr << "  -l <min> <max>        line sizes in bytes (default: 32 256)" << endl;
+	cerr << "  -t <hit> <penalty>    hit time and miss penalty in cycles (default: 5 100)" << endl;
+	cerr << "  -w <bits>             memory address width (default: 48)" << endl;
+	cerr << "  -r <policy>           replacement policy: lru, tree-plru, bit-plru, fifo, random," << endl;
+	cerr << "                        srrip, brrip, drrip (default: lru)" << endl;
+}
+
+int main(int argc, char **argv){
+
+	unsigned threads = 0;
+	unsigned min_size = 1, max_size = 1024;
+	unsigned min_assoc = 1, max_assoc = 16;
+	unsigned min_line = 32, max_line = 256;
+	unsigned hit_time = 5, miss_penalty = 100;
+	unsigned address_width = 48;
+	replacement_policy_t replacement = LRU;
+
+	int arg = 1;
+	for(; arg < argc && argv[arg][0] == '-'; arg++){
+		const char *opt = argv[arg];
+		int values = (strcmp(opt, "-j") == 0 || strcmp(opt, "-w") == 0 || strcmp(opt, "-r") == 0) ? 1 : 2;
+		if(strlen(opt) != 2 || arg + values >= argc){
+			usage(argv[0]);
+			return 1;
+		}
+		if(opt[1] == 'r'){
+			if(!parse_replacement_policy(argv[arg+1], replacement) || replacement == OPT){
+				usage(argv[0]);
+				return 1;
+			}
+			arg += values;
+			continue;
+		}
+		unsigned v1 = atoi(argv[arg+1]);
+		unsigned v2 = values == 2 ? atoi(argv[arg+2]) : 0;
+		switch(opt[1]){
+			case 'j': threads = v1; break;
+			case 'w': address_width = v1; break;
+			case 's': min_size = v1; max_size = v2; break;
+			case 'a': min_assoc = v1; max_assoc = v2; break;
+			case 'l': min_line = v1; max_line = v2; break;
+			case 't': hit_time = v1; miss_penalty = v2; break;
+			default: usage(argv[0]); return 1;
+		}
+		arg += values;
+	}
+	if(arg != argc - 1){
+		usage(argv[0]);
+		return 1;
+	}
+
+	cache_sweep sweep;
+	sweep.add_grid(min_size*KB, max_size*KB, min_assoc, max_assoc, min_line, max_line,
+				   hit_time, miss_penalty, address_width, replacement);
+
+	if(!sweep.load_trace(argv[arg])) return 1;
+
+	sweep.run(threads);
+	sweep.print_results();
+	return 0;
+}
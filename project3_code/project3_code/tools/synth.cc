@@ -0,0 +1,85 @@
+#include "cache.h"
+#include "workload.h"
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#define KB 1024
+
+using namespace std;
+
+/* Simulates a synthetic workload (see workload.h) on one cache, or writes it to a text trace */
+
+static void usage(const char *prog){
+	cerr << "usage: " << prog << " [options] <pattern> <footprint KB> <accesses> <size KB> <assoc> <line>" << endl;
+	cerr << "       " << prog << " [options] -o <trace> <pattern> <footprint KB> <accesses>" << endl;
+	cerr << "  patterns: sequential, strided, uniform, zipf, pointer-chase" << endl;
+	cerr << "  -w <percent>        writes among the accesses (default: 0)" << endl;
+	cerr << "  -s <seed>           PRNG seed (default: 1)" << endl;
+	cerr << "  -e <bytes>          element size (default: 8)" << endl;
+	cerr << "  -d <bytes>          stride of the strided pattern (default: 64)" << endl;
+	cerr << "  -z <theta>          skew of the zipf pattern, between 0 and 1 (default: 0.99)" << endl;
+	cerr << "  -r <policy>         replacement policy (default: lru)" << endl;
+	cerr << "  -t <hit> <penalty>  hit time and miss penalty in cycles (default: 5 100)" << endl;
+	cerr << "  -o <trace>          write the accesses to a text trace instead of simulating them" << endl;
+}
+
+int main(int argc, char **argv){
+
+	double write_ratio = 0;
+	uint64_t seed = 1;
+	unsigned element = 8, stride = 64;
+	double theta = 0.99;
+	replacement_policy_t replacement = LRU;
+	unsigned hit_time = 5, miss_penalty = 100;
+	const char *output = NULL;
+
+	int arg = 1;
+	for(; arg < argc && argv[arg][0] == '-'; arg++){
+		const char *opt = argv[arg];
+		int values = strcmp(opt, "-t") == 0 ? 2 : 1;
+		if(strlen(opt) != 2 || arg + values >= argc){
+			usage(argv[0]);
+			return 1;
+		}
+		const char *v = argv[arg+1];
+		switch(opt[1]){
+			case 'w': write_ratio = atof(v) / 100; break;
+			case 's': seed = strtoull(v, NULL, 0); break;
+			case 'e': element = atoi(v); break;
+			case 'd': stride = atoi(v); break;
+			case 'z': theta = atof(v); break;
+			case 'o': output = v; break;
+			case 't': hit_time = atoi(v); miss_penalty = atoi(argv[arg+2]); break;
+			case 'r':
+				if(!parse_replacement_policy(v, replacement) || replacement == OPT){
+					usage(argv[0]);
+					return 1;
+				}
+				break;
+			default: usage(argv[0]); return 1;
+		}
+		arg += values;
+	}
+
+	workload_t type;
+	if(argc - arg != (output != NULL ? 3 : 6) || !parse_workload(argv[arg], type) || theta <= 0 || theta >= 1){
+		usage(argv[0]);
+		return 1;
+	}
+	uint64_t footprint = strtoull(argv[arg+1], NULL, 0) * KB;
+	uint64_t accesses = strtoull(argv[arg+2], NULL, 0);
+
+	workload_generator workload(type, footprint, write_ratio, seed, element, stride, theta);
+
+	if(output != NULL) return workload.write_trace(output, accesses) ? 0 : 1;
+
+	cache *c = new cache(atoi(argv[arg+3])*KB, atoi(argv[arg+4]), atoi(argv[arg+5]),
+						 WRITE_BACK, WRITE_ALLOCATE, hit_time, miss_penalty, 48, replacement);
+	workload.run(c, accesses);
+	c->print_configuration();
+	c->print_statistics();
+
+	delete c;
+	return 0;
+}
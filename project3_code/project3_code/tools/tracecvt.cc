@@ -0,0 +1,34 @@
+#include "trace.h"
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+/* Converts a text trace ("r/w <hex address>" per line) into the binary trace format */
+
+static void usage(const char *prog){
+	cerr << "usage: " << prog << " [-d] <input trace> <output trace>" << endl;
+	cerr << "  -d   delta-encode the addresses (smaller file)" << endl;
+}
+
+int main(int argc, char **argv){
+
+	bool delta = false;
+	int arg = 1;
+
+	if(arg < argc && strcmp(argv[arg], "-d") == 0){
+		delta = true;
+		arg++;
+	}
+	if(argc - arg != 2){
+		usage(argv[0]);
+		return 1;
+	}
+
+	long long count = convert_trace(argv[arg], argv[arg+1], delta);
+	if(count < 0) return 1;
+
+	cout << "converted " << dec << count << " memory accesses" << endl;
+	return 0;
+}
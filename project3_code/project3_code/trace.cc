@@ -0,0 +1,408 @@
+#include "trace.h"
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unordered_map>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+trace_reader::trace_reader(){
+	binary = false;
+	delta = false;
+	map = NULL;
+	map_size = 0;
+	cur = NULL;
+	released = NULL;
+	end = NULL;
+	count = 0;
+	index = 0;
+	ops = 0;
+	prev = 0;
+}
+
+trace_reader::~trace_reader(){
+	close();
+}
+
+bool trace_reader::open(const char *filename){
+	close();
+
+	int fd = ::open(filename, O_RDONLY);
+	if(fd < 0){
+		cerr << "error: cannot open trace file " << filename << endl;
+		return false;
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) != 0){
+		::close(fd);
+		cerr << "error: cannot open trace file " << filename << endl;
+		return false;
+	}
+
+	// both formats are decoded in place from a read-only mapping
+	if(st.st_size > 0){
+		void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(p == MAP_FAILED){
+			::close(fd);
+			cerr << "error: cannot map trace file " << filename << endl;
+			return false;
+		}
+		madvise(p, st.st_size, MADV_SEQUENTIAL);
+		map = (unsigned char *) p;
+		map_size = st.st_size;
+	}
+	::close(fd);
+
+	cur = map;
+	released = map;
+	end = map + map_size;
+
+	// check the header to detect binary traces
+	if(map_size >= sizeof(trace_header_t) && memcmp(map, TRACE_MAGIC, 4) == 0){
+		if(!open_binary()){
+			cerr << "error: malformed trace file " << filename << endl;
+			close();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool trace_reader::open_binary(){
+	trace_header_t header;
+	memcpy(&header, map, sizeof(header));
+	if(header.version != TRACE_VERSION) return false;
+
+	delta = (header.flags & TRACE_FLAG_DELTA) != 0;
+	count = header.count;
+	cur = map + sizeof(header);
+
+	// raw traces have a fixed size, so they can be validated once here
+	// (the count is bounded by the size first, so that the products below cannot overflow)
+	if(!delta){
+		uint64_t size = end - cur;
+		if(count > size / sizeof(address_t)) return false;
+		uint64_t blocks = (count + TRACE_BLOCK - 1) / TRACE_BLOCK;
+		if(size < blocks * sizeof(uint64_t) + count * sizeof(address_t)) return false;
+	}
+
+	binary = true;
+	return true;
+}
+
+void trace_reader::close(){
+	if(map != NULL) munmap(map, map_size);
+
+	binary = false;
+	delta = false;
+	map = NULL;
+	map_size = 0;
+	cur = NULL;
+	end = NULL;
+	count = 0;
+	index = 0;
+	ops = 0;
+	prev = 0;
+}
+
+bool trace_reader::is_binary(){
+	return binary;
+}
+
+trace_position_t trace_reader::tell(){
+	trace_position_t position;
+	position.offset = cur - map;
+	position.index = index;
+	position.ops = ops;
+	position.prev = prev;
+	return position;
+}
+
+bool trace_reader::seek(const trace_position_t &position){
+	if(position.offset > map_size || (binary && position.index > count)) return false;
+	size_t page = sysconf(_SC_PAGESIZE);
+	cur = map + position.offset;
+	released = map + (position.offset & ~(page - 1));
+	index = position.index;
+	ops = position.ops;
+	prev = position.prev;
+	return true;
+}
+
+void trace_reader::release(){
+	// whole pages only (the mapping starts on a page boundary)
+	size_t page = sysconf(_SC_PAGESIZE);
+	const unsigned char *stop = map + ((cur - map) & ~(page - 1));
+	if(stop <= released) return;
+	madvise((void *) released, stop - released, MADV_DONTNEED);
+	released = stop;
+}
+
+unsigned trace_reader::read(trace_record_t *records, unsigned max){
+	unsigned n = 0;
+	while(n < max && next(records[n])) n++;
+	if(cur - released >= TRACE_RELEASE) release();
+	return n;
+}
+
+// value of each hex digit, 0xFF for any other character
+static const unsigned char hex_value[256] = {
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,  10,  11,  12,  13,  14,  15,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,  10,  11,  12,  13,  14,  15,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF
+};
+
+#ifdef __SSE2__
+// lane i is 0xFF if i >= 16, loaded at offset n to keep the last n lanes of a vector
+static const unsigned char tail_mask[32] = {
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF
+};
+
+// converts 16 characters to their hex digit values; "valid" flags the hex digits
+static inline __m128i hex_digits_sse2(__m128i v, __m128i &valid){
+	__m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+	__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+	__m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+	valid = _mm_or_si128(digit, alpha);
+	return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+						_mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+#endif
+
+// decodes the hex number at "p" (at most 16 digits) and advances "p" past it
+// returns false if there is no hex digit at "p", or if the number has more than 16 digits (it
+// does not fit in an address)
+inline bool trace_reader::parse_hex(const unsigned char *&p, address_t &value){
+#ifdef __SSE2__
+	// vector path: needs 16 readable bytes on both sides of the number
+	if(end - p >= 16 && p - map >= 16){
+		__m128i valid;
+		hex_digits_sse2(_mm_loadu_si128((const __m128i *) p), valid);
+		unsigned n = __builtin_ctz(~_mm_movemask_epi8(valid) | 0x10000);
+		if(n == 0) return false;
+		if(n < 16 || end - p == 16 || hex_value[p[16]] == 0xFF){
+			// reload so the number ends in the last lane, and drop the lanes before it
+			__m128i nib = hex_digits_sse2(_mm_loadu_si128((const __m128i *)(p + n - 16)), valid);
+			nib = _mm_and_si128(nib, _mm_loadu_si128((const __m128i *)(tail_mask + n)));
+
+			// merge pairs of digits into bytes (most significant byte first) and swap to host order
+			__m128i bytes = _mm_or_si128(_mm_slli_epi16(nib, 4), _mm_srli_epi16(nib, 8));
+			bytes = _mm_and_si128(bytes, _mm_set1_epi16(0x00FF));
+			bytes = _mm_packus_epi16(bytes, _mm_setzero_si128());
+			value = __builtin_bswap64((uint64_t) _mm_cvtsi128_si64(bytes));
+			p += n;
+			return true;
+		}
+	}
+#endif
+	// scalar path
+	if(p == end || hex_value[*p] == 0xFF) return false;
+	value = 0;
+	for(unsigned digits = 0; p < end && hex_value[*p] != 0xFF; digits++){
+		if(digits == 16) return false;
+		value = (value << 4) | hex_value[*p];
+		p++;
+	}
+	return true;
+}
+
+bool trace_reader::next_text(trace_record_t &rec){
+	const unsigned char *p = cur;
+
+	while(p < end){
+		// skip blank lines and leading white space
+		while(p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+		if(p == end) break;
+
+		// operation token
+		bool write = (*p != 'r');
+		while(p < end && *p != ' ' && *p != '\t' && *p != '\n') p++;
+		while(p < end && (*p == ' ' || *p == '\t')) p++;
+
+		// address token (optional 0x prefix)
+		if(end - p > 2 && p[0] == '0' && (p[1] | 0x20) == 'x' && hex_value[p[2]] != 0xFF) p += 2;
+		address_t address;
+		bool found = parse_hex(p, address);
+
+		// skip the rest of the line
+		const unsigned char *eol = (const unsigned char *) memchr(p, '\n', end - p);
+		p = (eol == NULL) ? end : eol + 1;
+
+		if(!found) continue; // lines without a valid address are ignored
+
+		rec.write = write;
+		rec.address = address;
+		cur = p;
+		return true;
+	}
+	cur = end;
+	return false;
+}
+
+bool trace_reader::next_delta(trace_record_t &rec){
+	if((index & (TRACE_BLOCK-1)) == 0){
+		if(end - cur < (ptrdiff_t) sizeof(ops)) return false;
+		memcpy(&ops, cur, sizeof(ops));
+		cur += sizeof(ops);
+	}
+
+	// LEB128 varint
+	uint64_t zz = 0;
+	unsigned shift = 0;
+	unsigned char byte;
+	do{
+		if(cur == end || shift > 63) return false; // truncated/corrupt trace
+		byte = *cur++;
+		zz |= (uint64_t)(byte & 0x7F) << shift;
+		shift += 7;
+	} while(byte & 0x80);
+
+	// zigzag decode
+	int64_t diff = (int64_t)(zz >> 1) ^ -(int64_t)(zz & 1);
+	prev += diff;
+
+	rec.write = (ops >> (index & (TRACE_BLOCK-1))) & 1;
+	rec.address = prev;
+	index++;
+	return true;
+}
+
+bool trace_buffer::load(const char *filename){
+	trace_reader in;
+	records.clear();
+	if(!in.open(filename)) return false;
+
+	trace_record_t rec;
+	while(in.next(rec)) records.push_back(rec);
+	return true;
+}
+
+size_t trace_buffer::size() const{
+	return records.size();
+}
+
+const trace_record_t *trace_buffer::data() const{
+	return records.data();
+}
+
+void trace_buffer::index_next_use(unsigned line_size){
+	unsigned offset_bits = 0;
+	while(line_size >>= 1) offset_bits++;
+
+	next_use.assign(records.size(), NEXT_USE_NONE);
+	std::unordered_map<address_t, size_t> later;	// block => index of its next access
+	later.reserve(records.size() / 4);
+	for(size_t i = records.size(); i-- > 0;){
+		address_t block = records[i].address >> offset_bits;
+		std::unordered_map<address_t, size_t>::iterator it = later.find(block);
+		if(it == later.end()){
+			later.emplace(block, i);
+		}else{
+			size_t distance = it->second - i;
+			next_use[i] = distance > UINT32_MAX ? UINT32_MAX : (uint32_t) distance;
+			it->second = i;
+		}
+	}
+}
+
+const uint32_t *trace_buffer::get_next_use() const{
+	return next_use.empty() ? NULL : next_use.data();
+}
+
+// writes one block (op mask followed by the addresses) to the output file
+static void write_block(ofstream &out, const trace_record_t *block, unsigned n, bool delta, address_t &prev){
+	unsigned char buf[sizeof(uint64_t) + TRACE_BLOCK * 10];
+	unsigned len = 0;
+
+	uint64_t ops = 0;
+	for(unsigned i = 0; i < n; i++){
+		if(block[i].write) ops |= (uint64_t)1 << i;
+	}
+	memcpy(buf, &ops, sizeof(ops));
+	len += sizeof(ops);
+
+	for(unsigned i = 0; i < n; i++){
+		if(!delta){
+			memcpy(buf + len, &block[i].address, sizeof(address_t));
+			len += sizeof(address_t);
+			continue;
+		}
+		int64_t diff = (int64_t)(block[i].address - prev);
+		uint64_t zz = ((uint64_t) diff << 1) ^ (uint64_t)(diff >> 63);
+		prev = block[i].address;
+		do{
+			unsigned char byte = zz & 0x7F;
+			zz >>= 7;
+			if(zz) byte |= 0x80;
+			buf[len++] = byte;
+		} while(zz);
+	}
+
+	out.write((const char *) buf, len);
+}
+
+long long convert_trace(const char *in_filename, const char *out_filename, bool delta){
+	trace_reader in;
+	if(!in.open(in_filename)) return -1;
+
+	ofstream out(out_filename, ios::out | ios::binary | ios::trunc);
+	if(!out.is_open()){
+		cerr << "error: cannot create trace file " << out_filename << endl;
+		return -1;
+	}
+
+	// the header is rewritten once the number of records is known
+	trace_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+	header.version = TRACE_VERSION;
+	header.flags = delta ? TRACE_FLAG_DELTA : 0;
+	out.write((const char *) &header, sizeof(header));
+
+	trace_record_t block[TRACE_BLOCK];
+	unsigned n = 0;
+	address_t prev = 0;
+	uint64_t count = 0;
+
+	while(in.next(block[n])){
+		count++;
+		if(++n == TRACE_BLOCK){
+			write_block(out, block, n, delta, prev);
+			n = 0;
+		}
+	}
+	if(n) write_block(out, block, n, delta, prev);
+
+	header.count = count;
+	out.seekp(0);
+	out.write((const char *) &header, sizeof(header));
+	out.close();
+
+	if(out.fail()){
+		cerr << "error: cannot write trace file " << out_filename << endl;
+		return -1;
+	}
+	return count;
+}
@@ -0,0 +1,151 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+typedef unsigned long long address_t; //memory address type
+
+/* Binary trace format
+ *
+ * header (trace_header_t), followed by the records grouped in blocks of TRACE_BLOCK:
+ *	- one 64-bit op mask (bit i set => record i of the block is a write)
+ *	- up to TRACE_BLOCK addresses, either
+ *		raw:   64-bit little-endian address per record
+ *		delta: LEB128 varint of the zigzag-encoded difference to the previous address
+ *	       (the first address of the trace is relative to 0)
+ * The last block may be partial; the header holds the total number of records.
+ */
+
+#define TRACE_MAGIC "CTRB"
+#define TRACE_VERSION 1
+#define TRACE_FLAG_DELTA 0x1	// addresses are delta/varint encoded
+#define TRACE_BLOCK 64			// records per op mask
+
+#define TRACE_RELEASE (64 << 20)	// bytes decoded between two releases of the pages already read
+
+typedef struct{
+	char magic[4];		// TRACE_MAGIC
+	uint32_t version;	// TRACE_VERSION
+	uint32_t flags;		// TRACE_FLAG_*
+	uint32_t reserved;
+	uint64_t count;		// number of records in the trace
+} trace_header_t;
+
+typedef struct{
+	address_t address;	// memory address
+	bool write;			// true for a write, false for a read
+} trace_record_t;
+
+// decoder state of a trace_reader (see trace_reader::tell)
+typedef struct{
+	uint64_t offset;	// byte of the file decoded next
+	uint64_t index;		// number of records decoded so far
+	uint64_t ops;		// op mask of the current block (binary traces)
+	address_t prev;		// previous address (delta encoding)
+} trace_position_t;
+
+class trace_reader{
+
+	/* text ("r/w <hex address>" per line) and binary traces are both memory mapped */
+	bool binary;
+	bool delta;
+	unsigned char *map;			// start of the mapping
+	size_t map_size;			// size of the mapping (in bytes)
+	const unsigned char *cur;	// next byte to decode
+	const unsigned char *released;	// the pages before it were released (the trace is read once)
+	const unsigned char *end;	// end of the mapping
+	uint64_t count;				// number of records in the trace
+	uint64_t index;				// number of records decoded so far
+	uint64_t ops;				// op mask of the current block
+	address_t prev;				// previous address (delta encoding)
+
+	bool open_binary();
+
+	// drops the pages decoded so far from memory, so that the resident size of a long trace stays bounded
+	void release();
+	inline bool parse_hex(const unsigned char *&p, address_t &value);
+	bool next_text(trace_record_t &rec);
+	bool next_delta(trace_record_t &rec);
+
+public:
+
+	trace_reader();
+	~trace_reader();
+
+	// opens a text or binary trace (the format is detected from the header)
+	// returns false if the file cannot be opened or is malformed
+	bool open(const char *filename);
+
+	// releases the trace file
+	void close();
+
+	// returns true if the trace is a memory mapped binary trace
+	bool is_binary();
+
+	// decodes the next record of the trace; returns false at the end of the trace
+	inline bool next(trace_record_t &rec);
+
+	// decodes up to "max" records; returns the number decoded (less than "max" at the end of the trace)
+	unsigned read(trace_record_t *records, unsigned max);
+
+	// returns the position of the next record, to resume decoding there with "seek"
+	trace_position_t tell();
+
+	// resumes decoding at a position returned by "tell" for the same trace file
+	// returns false if the position is not in the trace
+	bool seek(const trace_position_t &position);
+};
+
+inline bool trace_reader::next(trace_record_t &rec){
+	if(!binary) return next_text(rec);
+	if(index == count) return false;
+	if(delta) return next_delta(rec);
+
+	// raw records: the op mask is followed by one 64-bit address per record
+	if((index & (TRACE_BLOCK-1)) == 0){
+		memcpy(&ops, cur, sizeof(ops));
+		cur += sizeof(ops);
+	}
+	rec.write = (ops >> (index & (TRACE_BLOCK-1))) & 1;
+	memcpy(&rec.address, cur, sizeof(rec.address));
+	cur += sizeof(rec.address);
+	index++;
+	return true;
+}
+
+#define NEXT_USE_NONE 0		// next-use distance of the last access to a block
+
+/* A whole trace decoded in memory, shared read-only by several simulations */
+class trace_buffer{
+
+	std::vector<trace_record_t> records;
+	std::vector<uint32_t> next_use;		// [i] => accesses until the block of record i is accessed again
+
+public:
+
+	// decodes the trace file (text or binary); returns false if it cannot be opened
+	bool load(const char *filename);
+
+	// returns the number of records
+	size_t size() const;
+
+	// returns the decoded records
+	const trace_record_t *data() const;
+
+	// computes, with a reverse pass over the records, the next-use distance of each record for
+	// blocks of "line_size" bytes (NEXT_USE_NONE if the block is not accessed again; distances
+	// that do not fit in 32 bits are saturated)
+	void index_next_use(unsigned line_size);
+
+	// returns the next-use distances (NULL if "index_next_use" was not called)
+	const uint32_t *get_next_use() const;
+};
+
+// converts a trace (text or binary) into the binary format
+// returns the number of records written, or -1 on error
+long long convert_trace(const char *in_filename, const char *out_filename, bool delta);
+
+#endif /*TRACE_H_*/
@@ -0,0 +1,105 @@
+#include "trace_prefetch.h"
+
+using namespace std;
+
+trace_prefetcher::trace_prefetcher(){
+	produced = 0;
+	consumed = 0;
+	stopping = false;
+	holding = false;
+	position = 0;
+	finished = true;
+}
+
+trace_prefetcher::~trace_prefetcher(){
+	close();
+}
+
+bool trace_prefetcher::open(const char *filename){
+	close();
+	if(!reader.open(filename)) return false;
+
+	ring.resize((size_t) PREFETCH_BLOCKS * PREFETCH_BLOCK);
+	produced = 0;
+	consumed = 0;
+	stopping = false;
+	holding = false;
+	position = 0;
+	finished = false;
+	worker = thread(&trace_prefetcher::produce, this);
+	return true;
+}
+
+void trace_prefetcher::close(){
+	if(worker.joinable()){
+		{
+			lock_guard<mutex> l(lock);
+			stopping = true;
+		}
+		changed.notify_all();
+		worker.join();
+	}
+	reader.close();
+	finished = true;
+}
+
+void trace_prefetcher::advance(atomic<uint64_t> &counter, uint64_t value){
+	counter.store(value, memory_order_release);
+	// taking the lock orders the store with a waiter testing the counter before it sleeps
+	{
+		lock_guard<mutex> l(lock);
+	}
+	changed.notify_one();
+}
+
+void trace_prefetcher::produce(){
+	for(;;){
+		// wait for a free block
+		uint64_t block = produced.load(memory_order_relaxed);
+		if(block - consumed.load(memory_order_acquire) == PREFETCH_BLOCKS){
+			unique_lock<mutex> l(lock);
+			while(!stopping && block - consumed.load(memory_order_acquire) == PREFETCH_BLOCKS) changed.wait(l);
+			if(stopping) return;
+		}
+
+		unsigned slot = block % PREFETCH_BLOCKS;
+		unsigned n = reader.read(ring.data() + (size_t) slot * PREFETCH_BLOCK, PREFETCH_BLOCK);
+		sizes[slot] = n;
+		advance(produced, block + 1);
+		if(n < PREFETCH_BLOCK || stopping) return;
+	}
+}
+
+unsigned trace_prefetcher::read(trace_record_t *records, unsigned max){
+	unsigned copied = 0;
+
+	while(copied < max){
+		uint64_t block = consumed.load(memory_order_relaxed);
+		unsigned slot = block % PREFETCH_BLOCKS;
+
+		if(!holding){
+			if(finished) break;
+			// wait for the reader thread to fill the block
+			if(produced.load(memory_order_acquire) == block){
+				unique_lock<mutex> l(lock);
+				while(produced.load(memory_order_acquire) == block) changed.wait(l);
+			}
+			holding = true;
+			position = 0;
+		}
+
+		unsigned n = sizes[slot] - position;
+		if(n > max - copied) n = max - copied;
+		memcpy(records + copied, ring.data() + (size_t) slot * PREFETCH_BLOCK + position, n * sizeof(trace_record_t));
+		copied += n;
+		position += n;
+
+		// release the block once it is read
+		if(position == sizes[slot]){
+			if(sizes[slot] < PREFETCH_BLOCK) finished = true;
+			holding = false;
+			advance(consumed, block + 1);
+		}
+	}
+	return copied;
+}
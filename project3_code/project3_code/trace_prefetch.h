@@ -0,0 +1,63 @@
+#ifndef TRACE_PREFETCH_H_
+#define TRACE_PREFETCH_H_
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "trace.h"
+
+using namespace std;
+
+#define PREFETCH_BLOCK 16384	// records per block of the ring
+#define PREFETCH_BLOCKS 4		// blocks of the ring (the reader runs at most this far ahead)
+
+/* Trace reader decoding the trace on a background thread
+ * the reader thread fills the blocks of a single-producer/single-consumer ring, and the simulation
+ * thread copies the decoded records out of it; the two threads only share the block counters, and
+ * a thread finding the ring full (or empty) sleeps until the other one moves its counter */
+class trace_prefetcher{
+
+	trace_reader reader;
+	thread worker;
+
+	vector<trace_record_t> ring;		// PREFETCH_BLOCKS blocks of PREFETCH_BLOCK records
+	unsigned sizes[PREFETCH_BLOCKS];	// records in each block (less than PREFETCH_BLOCK: end of the trace)
+	atomic<uint64_t> produced;			// blocks filled by the reader thread
+	atomic<uint64_t> consumed;			// blocks released by the consumer
+	atomic<bool> stopping;
+	mutex lock;							// guards the waits on "changed"
+	condition_variable changed;			// signalled when a counter moves or the reader is stopped
+
+	/* consumer side */
+	bool holding;		// the block consumed % PREFETCH_BLOCKS is being read
+	unsigned position;	// next record of the block being read
+	bool finished;		// the last block of the trace was read
+
+	// main loop of the reader thread
+	void produce();
+
+	// stores "value" to "counter" and wakes the other thread
+	void advance(atomic<uint64_t> &counter, uint64_t value);
+
+public:
+
+	trace_prefetcher();
+
+	// stops the reader thread
+	~trace_prefetcher();
+
+	// opens a text or binary trace and starts decoding it in the background
+	// returns false if the file cannot be opened or is malformed
+	bool open(const char *filename);
+
+	// stops the reader thread and releases the trace file
+	void close();
+
+	// copies up to "max" decoded records to "records"; returns the number copied, which is less
+	// than "max" only at the end of the trace (the next call resumes after the last record copied)
+	unsigned read(trace_record_t *records, unsigned max);
+};
+
+#endif /*TRACE_PREFETCH_H_*/
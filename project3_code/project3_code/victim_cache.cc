@@ -0,0 +1,107 @@
+#include "victim_cache.h"
+#include <iostream>
+
+using namespace std;
+
+victim_cache::victim_cache(unsigned entries, bool miss_cache, unsigned hit_time){
+	this->miss_cache = miss_cache;
+	this->entries = entries ? entries : 1;
+	this->hit_time = hit_time;
+
+	blocks.assign(this->entries, 0);
+	dirty.assign(this->entries, 0);
+	valid.assign(this->entries, 0);
+	used.assign(this->entries, 0);
+	time = 0;
+
+	probes = 0;
+	hits = 0;
+	write_hits = 0;
+	write_backs = 0;
+}
+
+unsigned victim_cache::find(address_t block){
+	for(unsigned i = 0; i < entries; i++){
+		if(valid[i] && blocks[i] == block) return i;
+	}
+	return entries;
+}
+
+bool victim_cache::lookup(address_t block, bool &was_dirty){
+	probes++;
+	time++;
+	was_dirty = false;
+
+	unsigned i = find(block);
+	if(i < entries){
+		hits++;
+		if(miss_cache){
+			used[i] = time;
+		}else{
+			// the line moves to the cache (its slot takes the victim of the cache)
+			was_dirty = dirty[i];
+			valid[i] = 0;
+			dirty[i] = 0;
+		}
+		return true;
+	}
+
+	if(miss_cache) insert(block, false);
+	return false;
+}
+
+bool victim_cache::write(address_t block){
+	unsigned i = find(block);
+	if(i == entries) return false;
+	write_hits++;
+	used[i] = ++time;
+	return true;
+}
+
+bool victim_cache::insert(address_t block, bool is_dirty){
+	time++;
+
+	// free or least recently used entry
+	unsigned slot = 0;
+	for(unsigned i = 0; i < entries; i++){
+		if(!valid[i]){
+			slot = i;
+			break;
+		}
+		if(used[i] < used[slot]) slot = i;
+	}
+
+	bool write_back = valid[slot] && dirty[slot];
+	if(write_back) write_backs++;
+
+	blocks[slot] = block;
+	dirty[slot] = is_dirty;
+	valid[slot] = 1;
+	used[slot] = time;
+	return write_back;
+}
+
+bool victim_cache::is_miss_cache(){
+	return miss_cache;
+}
+
+unsigned victim_cache::get_entries(){
+	return entries;
+}
+
+unsigned victim_cache::get_hit_time(){
+	return hit_time;
+}
+
+unsigned long long victim_cache::get_hits(){
+	return hits;
+}
+
+void victim_cache::print_statistics(){
+	const char *name = miss_cache ? "miss cache" : "victim cache";
+	cout << name << " entries = " << std::dec << entries << endl;
+	cout << name << " probes = " << std::dec << probes << endl;
+	cout << name << " hits = " << std::dec << hits << endl;
+	cout << name << " write hits = " << std::dec << write_hits << endl;
+	if(!miss_cache) cout << name << " write-backs = " << std::dec << write_backs << endl;
+}
@@ -0,0 +1,61 @@
+#ifndef VICTIM_CACHE_H_
+#define VICTIM_CACHE_H_
+
+#include <vector>
+#include "trace.h"
+
+using namespace std;
+
+/* Small fully-associative LRU buffer probed on the misses of a cache (Jouppi, ISCA 1990)
+ *	- victim cache: holds the lines evicted from the cache; on a hit, the line moves back to the
+ *	  cache and the line it replaces takes its place in the buffer (swap)
+ *	- miss cache: holds a copy of the lines brought in by the last misses; on a hit, the line is
+ *	  copied to the cache
+ * the buffer is searched linearly, it is meant to have a few entries (e.g., 1 to 16) */
+class victim_cache{
+
+	bool miss_cache;				// miss cache instead of victim cache
+	unsigned entries;
+	unsigned hit_time;				// cycles to serve a miss of the cache from the buffer
+
+	vector<address_t> blocks;		// block address (address / line size) of each entry
+	vector<unsigned char> dirty;	// the entry holds the only up-to-date copy (victim cache)
+	vector<unsigned char> valid;
+	vector<unsigned long long> used;	// time of the last access (LRU)
+	unsigned long long time;
+
+	unsigned long long probes;		// misses of the cache looked up in the buffer
+	unsigned long long hits;
+	unsigned long long write_hits;	// writes not allocated by the cache that updated an entry
+	unsigned long long write_backs;	// dirty lines evicted from the buffer
+
+	// returns the entry holding "block", or "entries" if there is none
+	unsigned find(address_t block);
+
+public:
+
+	victim_cache(unsigned entries, bool miss_cache, unsigned hit_time);
+
+	// looks up the block missed by the cache; returns true on a hit ("was_dirty" tells if the line
+	// must be marked dirty in the cache). A victim cache gives the line back to the cache, a miss
+	// cache keeps its copy; on a miss, a miss cache keeps a copy of the block fetched by the cache
+	bool lookup(address_t block, bool &was_dirty);
+
+	// passes on a write the cache does not allocate (no-write-allocate miss); returns true if the
+	// buffer holds the block, whose copy is updated (the write still goes to memory)
+	bool write(address_t block);
+
+	// places a line evicted from the cache (victim cache); returns true if a dirty line had to be
+	// evicted from the buffer to make room for it (a write-back)
+	bool insert(address_t block, bool is_dirty);
+
+	bool is_miss_cache();
+	unsigned get_entries();
+	unsigned get_hit_time();
+	unsigned long long get_hits();
+
+	// prints the counters of the buffer
+	void print_statistics();
+};
+
+#endif /*VICTIM_CACHE_H_*/
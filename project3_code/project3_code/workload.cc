@@ -0,0 +1,152 @@
+#include "workload.h"
+#include "cache.h"
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+using namespace std;
+
+#define WORKLOAD_BLOCK 4096 // accesses generated at once by "run" and "write_trace"
+
+static const char *workload_names[] = {"sequential", "strided", "uniform", "zipf", "pointer-chase"};
+
+const char *workload_name(workload_t type){
+	return workload_names[type];
+}
+
+bool parse_workload(const char *name, workload_t &type){
+	for(unsigned i = 0; i < sizeof(workload_names) / sizeof(workload_names[0]); i++){
+		if(strcmp(name, workload_names[i]) == 0){
+			type = (workload_t) i;
+			return true;
+		}
+	}
+	return false;
+}
+
+workload_generator::workload_generator(workload_t type, uint64_t footprint, double write_ratio, uint64_t seed,
+									   unsigned element, unsigned stride, double theta, address_t base){
+	this->type = type;
+	this->base = base;
+	this->element = element ? element : 1;
+	this->stride = stride ? stride : this->element;
+	this->elements = footprint / this->element;
+	if(elements == 0) elements = 1;
+	this->write_ratio = write_ratio;
+	if(write_ratio <= 0 || write_ratio >= 1) write_threshold = 0; // never or always a write
+	else write_threshold = (uint64_t) (write_ratio * 18446744073709551616.0);
+	this->seed = seed;
+	this->theta = theta;
+	alpha = zetan = eta = 0;
+
+	if(type == ZIPF){
+		double zeta2 = 1 + pow(0.5, theta);
+		zetan = 0;
+		for(uint64_t i = 1; i <= elements; i++) zetan += 1 / pow((double) i, theta);
+		alpha = 1 / (1 - theta);
+		eta = (1 - pow(2.0 / elements, 1 - theta)) / (1 - zeta2 / zetan);
+	}
+	if(type == POINTER_CHASE && elements > UINT32_MAX){
+		cerr << "error: pointer-chase footprint limited to " << UINT32_MAX << " elements" << endl;
+		elements = UINT32_MAX;
+	}
+	reset();
+}
+
+void workload_generator::reset(){
+	state = seed;
+	position = 0;
+	if(type != POINTER_CHASE) return;
+
+	// random cyclic permutation (Sattolo's algorithm), so the chase visits every element
+	chain.resize(elements);
+	for(uint64_t i = 0; i < elements; i++) chain[i] = i;
+	for(uint64_t i = elements - 1; i > 0; i--){
+		uint64_t j = next_random() % i;
+		uint32_t t = chain[i];
+		chain[i] = chain[j];
+		chain[j] = t;
+	}
+}
+
+// splitmix64
+inline uint64_t workload_generator::next_random(){
+	uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+inline double workload_generator::next_unit(){
+	return (next_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+inline uint64_t workload_generator::next_element(){
+	uint64_t e;
+	switch(type){
+		case SEQUENTIAL:
+			e = position;
+			if(++position == elements) position = 0;
+			return e;
+		case STRIDED:
+			e = position * stride / element;
+			position++;
+			if(position * stride / element >= elements) position = 0;
+			return e;
+		case UNIFORM:
+			return next_random() % elements;
+		case ZIPF: {
+			double u = next_unit();
+			double uz = u * zetan;
+			if(uz < 1) return 0;
+			if(uz < 1 + pow(0.5, theta)) return elements > 1 ? 1 : 0;
+			e = (uint64_t) (elements * pow(eta * u - eta + 1, alpha));
+			return e < elements ? e : elements - 1;
+		}
+		case POINTER_CHASE:
+			e = position;
+			position = chain[position];
+			return e;
+	}
+	return 0;
+}
+
+unsigned workload_generator::read(trace_record_t *records, unsigned max){
+	for(unsigned i = 0; i < max; i++){
+		records[i].address = base + next_element() * element;
+		records[i].write = write_ratio >= 1 || next_random() < write_threshold;
+	}
+	return max;
+}
+
+void workload_generator::run(cache *c, uint64_t count){
+	if(c->get_replacement_policy() == OPT){
+		cerr << "error: OPT replacement needs a trace loaded with load_trace" << endl;
+		return;
+	}
+	trace_record_t block[WORKLOAD_BLOCK];
+	while(count != 0){
+		unsigned n = count < WORKLOAD_BLOCK ? count : WORKLOAD_BLOCK;
+		read(block, n);
+		c->access_batch(block, n);
+		count -= n;
+	}
+}
+
+bool workload_generator::write_trace(const char *filename, uint64_t count){
+	FILE *out = fopen(filename, "w");
+	if(out == NULL){
+		cerr << "error: cannot create trace " << filename << endl;
+		return false;
+	}
+	trace_record_t block[WORKLOAD_BLOCK];
+	while(count != 0){
+		unsigned n = count < WORKLOAD_BLOCK ? count : WORKLOAD_BLOCK;
+		read(block, n);
+		for(unsigned i = 0; i < n; i++)
+			fprintf(out, "%c 0x%llx\n", block[i].write ? 'w' : 'r', block[i].address);
+		count -= n;
+	}
+	return fclose(out) == 0;
+}
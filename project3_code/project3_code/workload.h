@@ -0,0 +1,86 @@
+#ifndef WORKLOAD_H_
+#define WORKLOAD_H_
+
+#include <vector>
+#include <stdint.h>
+#include "trace.h"
+
+using namespace std;
+
+class cache;
+
+// access patterns of the synthetic workloads
+typedef enum {SEQUENTIAL, STRIDED, UNIFORM, ZIPF, POINTER_CHASE} workload_t;
+
+// returns the name of a workload pattern (e.g., "zipf")
+const char *workload_name(workload_t type);
+
+// parses a workload pattern name into "type"; returns false if the name is unknown
+bool parse_workload(const char *name, workload_t &type);
+
+/* Synthetic access streams, generated in memory from a seeded PRNG (the same parameters
+ * always give the same stream)
+ * the footprint is divided in elements of "element" bytes:
+ *	- sequential:    element 0, 1, 2, ... (wrapping around at the end of the footprint)
+ *	- strided:       same, every "stride" bytes
+ *	- uniform:       uniformly random elements
+ *	- zipf:          element of rank k with probability proportional to 1/k^theta
+ *	                 (element 0 is the hottest)
+ *	- pointer-chase: a random cycle visiting every element once (each access depends on the previous)
+ * each access is a write with probability "write_ratio" */
+class workload_generator{
+
+	workload_t type;
+	address_t base;			// address of element 0
+	uint64_t elements;		// number of elements in the footprint
+	unsigned element;		// element size (in bytes)
+	unsigned stride;		// distance between two strided accesses (in bytes)
+	double write_ratio;
+	uint64_t write_threshold;	// a random 64-bit value below it is a write (write_ratio < 1)
+	uint64_t seed;
+	uint64_t state;			// PRNG state
+	uint64_t position;		// next element (sequential, strided and pointer-chase)
+
+	// zipf: constants of the generator (Gray et al., "Quickly generating billion-record synthetic databases")
+	double theta, alpha, zetan, eta;
+
+	// pointer-chase: next element of each element
+	vector<uint32_t> chain;
+
+	inline uint64_t next_random();
+
+	// returns a random number in [0, 1)
+	inline double next_unit();
+
+	// returns the element of the next access
+	inline uint64_t next_element();
+
+public:
+
+	workload_generator(
+		workload_t type,			// access pattern
+		uint64_t footprint,			// bytes touched by the workload
+		double write_ratio=0,		// fraction of the accesses that are writes
+		uint64_t seed=1,			// PRNG seed
+		unsigned element=8,			// element size (in bytes)
+		unsigned stride=64,			// distance between strided accesses (in bytes)
+		double theta=0.99,			// skew of the zipf pattern (0 < theta < 1)
+		address_t base=0x10000000	// address of the first element
+	);
+
+	// restarts the stream from its first access
+	void reset();
+
+	// generates the next "max" accesses; returns "max" (same interface as trace_reader::read)
+	unsigned read(trace_record_t *records, unsigned max);
+
+	// simulates the next "count" accesses of the stream on the cache "c"
+	// (not with the OPT policy, which needs the next-use distances of a loaded trace)
+	void run(cache *c, uint64_t count);
+
+	// writes the next "count" accesses to a text trace ("r/w <hex address>" per line)
+	// returns false if the file cannot be created
+	bool write_trace(const char *filename, uint64_t count);
+};
+
+#endif /*WORKLOAD_H_*/